@@ -0,0 +1,211 @@
+/// @brief Orthogonal component container whose component set is chosen
+///        at run time. See Samek, Chapter 5, section 5.4 Orthogonal
+///        Component.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_DYNAMIC_ORTHOGONAL_CONTAINER_HPP
+#define CMS_DYNAMIC_ORTHOGONAL_CONTAINER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "cmsOrthogonalComponent.hpp"
+#include "cmsOrthogonalSignalRouter.hpp"
+
+namespace cms {
+
+/// The DynamicOrthogonalContainer is a QP::QActive holding up to
+/// MaxComponents OrthogonalComponents, selected at run time (for example
+/// from a product configuration) rather than through a template parameter
+/// pack. Components are constructed in place, one after another, in a
+/// fixed size arena inside the container itself. There is no heap use.
+///
+/// Components must be added before the container is started, usually
+/// by the registration callable given to the constructor. Subscription,
+/// start order, and dispatch semantics match OrthogonalContainer,
+/// including its signal routing table and first-match support.
+///
+/// Only OrthogonalComponent (virtual) components are supported, as the
+/// container knows their concrete types only while adding them.
+///
+/// \tparam MaxComponents - the most components this container may hold.
+/// \tparam ArenaBytes - storage for all components, including padding.
+template <std::size_t MaxComponents, std::size_t ArenaBytes>
+class DynamicOrthogonalContainer : public QP::QActive {
+public:
+    using Router = OrthogonalSignalRouter<MaxComponents>;
+
+    DynamicOrthogonalContainer() :
+        QP::QActive(Q_STATE_CAST(initial)), m_arena(), m_arenaUsed(0U),
+        m_components(), m_componentCount(0U), m_router(), m_isStarted(false)
+    {
+        m_components.fill(nullptr);
+    }
+
+    /// \param registrar - callable as registrar(*this), which adds the
+    ///                    desired components with addComponent().
+    template <class Registrar>
+    explicit DynamicOrthogonalContainer(Registrar registrar) :
+        DynamicOrthogonalContainer()
+    {
+        registrar(*this);
+    }
+
+    virtual ~DynamicOrthogonalContainer()
+    {
+        for (std::size_t i = m_componentCount; i > 0U; --i) {
+            m_components[i - 1U]->~OrthogonalComponent();
+        }
+    }
+
+    DynamicOrthogonalContainer(const DynamicOrthogonalContainer&) = delete;
+    DynamicOrthogonalContainer&
+    operator=(const DynamicOrthogonalContainer&)             = delete;
+    DynamicOrthogonalContainer(DynamicOrthogonalContainer&&) = delete;
+    DynamicOrthogonalContainer&
+    operator=(DynamicOrthogonalContainer&&) = delete;
+
+    /// Construct a component of type C in the arena, passing this
+    /// container followed by 'args' to its constructor. Components
+    /// start and receive events in the order they were added.
+    /// \return the new component, or nullptr (nothing constructed) if
+    ///         the container is started, already holds MaxComponents,
+    ///         or its arena lacks room for a C. Checked in every build.
+    template <class C, class... Args>
+    C* addComponent(Args&&... args)
+    {
+        static_assert(std::is_base_of<OrthogonalComponent, C>::value,
+                      "component must be derived from OrthogonalComponent");
+        static_assert(alignof(C) <= alignof(std::max_align_t),
+                      "over-aligned components are not supported");
+
+        if (m_isStarted || (m_componentCount >= MaxComponents)) {
+            return nullptr;
+        }
+
+        const std::size_t offset = AlignUp(m_arenaUsed, alignof(C));
+        if ((offset > ArenaBytes) || (sizeof(C) > ArenaBytes - offset)) {
+            return nullptr;
+        }
+
+        C* component = ::new (static_cast<void*>(&m_arena[offset]))
+          C(this, std::forward<Args>(args)...);
+        m_arenaUsed                      = offset + sizeof(C);
+        m_components[m_componentCount++] = component;
+        return component;
+    }
+
+    std::size_t componentCount() const { return m_componentCount; }
+
+    std::size_t arenaBytesUsed() const { return m_arenaUsed; }
+
+protected:
+    static QP::QState initial(DynamicOrthogonalContainer* const me,
+                              QP::QEvt const* const)
+    {
+        me->m_isStarted = true;
+        for (std::size_t i = 0U; i < me->m_componentCount; ++i) {
+            me->m_components[i]->start();
+        }
+        me->m_router.build(me->m_componentCount,
+                           [me](std::size_t index, enum_t sig) {
+                               return me->m_components[index]
+                                 ->componentSignalInterest(sig);
+                           });
+        return me->tran(Q_STATE_CAST(&running));
+    }
+
+    static QP::QState running(DynamicOrthogonalContainer* const me,
+                              QP::QEvt const* const e)
+    {
+        QP::QState rtn;
+        switch (e->sig) {
+            case Q_ENTRY_SIG:   // purposeful fall through
+            case Q_EXIT_SIG:
+            case Q_INIT_SIG:
+                rtn = Q_HANDLED();
+                break;
+            default: {
+                bool handled = me->m_router.isRouted(e->sig)
+                                 ? me->routedDispatch(e)
+                                 : me->scanDispatch(e);
+
+                if (handled) {
+                    rtn = Q_HANDLED();
+                }
+                else {
+                    rtn = me->super(&top);
+                }
+            } break;
+        }
+        return rtn;
+    }
+
+private:
+    static constexpr std::size_t AlignUp(std::size_t value,
+                                         std::size_t alignment)
+    {
+        return (value + alignment - 1U) & ~(alignment - 1U);
+    }
+
+    bool routedDispatch(QP::QEvt const* const e)
+    {
+        typename Router::Mask mask = m_router.route(e->sig);
+        Router::ForEachRouted(mask, [this, e](std::size_t index) {
+            m_components[index]->componentDispatchRouted(e);
+        });
+        return mask != 0U;
+    }
+
+    // fallback for signals beyond the routing table
+    bool scanDispatch(QP::QEvt const* const e)
+    {
+        bool handled = false;
+        for (std::size_t i = 0U; i < m_componentCount; ++i) {
+            SignalInterest interest =
+              m_components[i]->componentSignalInterest(e->sig);
+            if (interest != SignalInterest::NONE) {
+                m_components[i]->componentDispatchRouted(e);
+                handled = true;
+                if (interest == SignalInterest::CONSUMED) {
+                    break;
+                }
+            }
+        }
+        return handled;
+    }
+
+    alignas(std::max_align_t) std::array<std::uint8_t, ArenaBytes> m_arena;
+    std::size_t m_arenaUsed;
+    std::array<OrthogonalComponent*, MaxComponents> m_components;
+    std::size_t m_componentCount;
+    Router m_router;
+    bool m_isStarted;
+};
+
+}   // namespace cms
+
+#endif   // CMS_DYNAMIC_ORTHOGONAL_CONTAINER_HPP
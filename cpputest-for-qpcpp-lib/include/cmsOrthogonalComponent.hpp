@@ -26,10 +26,20 @@
 #define CMS_ORTHOGONAL_COMPONENT_HPP
 
 #include <cassert>
+#include <cstdint>
 #include "qpcpp.hpp"
+#include "cms_cpputest_state_coverage.hpp"
 
 namespace cms {
 
+/// How a component responds to a signal, as seen by the routing table
+/// of its containing active object.
+enum class SignalInterest : std::uint8_t {
+    NONE,       ///< the component does not process the signal
+    SHARED,     ///< the component processes the signal, as may others
+    CONSUMED    ///< the component processes the signal, later ones do not
+};
+
 /// The OrthogonalComponent class provides for an interface
 /// and standard method to define QHsm components that assume
 /// an Orthogonal Component Container parent/owner. This approach
@@ -50,9 +60,9 @@ public:
     OrthogonalComponent& operator=(const OrthogonalComponent&)  = delete;
     OrthogonalComponent& operator=(OrthogonalComponent&& other) = delete;
 
-    /// @note Due to the way the OrthogonalContainer creates Components,
-    ///       a valid move constructor is required
-    ///       of any concrete Component
+    /// @note The OrthogonalContainer constructs Components in place and
+    ///       no longer requires a move constructor. This one remains for
+    ///       existing concrete Components which define their own.
     OrthogonalComponent(OrthogonalComponent&& other) noexcept :
         QP::QHsm(other), m_container(other.m_container), m_qs_id(other.m_qs_id)
     {
@@ -70,11 +80,30 @@ public:
         assert(m_container != nullptr);
         bool desired = isSignalDesired(e->sig);
         if (desired) {
-            QP::QHsm::dispatch(e, m_qs_id);
+            componentDispatchRouted(e);
         }
         return desired;
     }
 
+    /// Dispatch an event which the container has already routed
+    /// to this component, skipping the isSignalDesired() check.
+    void componentDispatchRouted(QP::QEvt const* const e)
+    {
+        assert(m_container != nullptr);
+        CMS_STATE_COVERAGE_RECORD(this, e);
+        QP::QHsm::dispatch(e, m_qs_id);
+    }
+
+    /// Used by the container when building its signal routing table.
+    SignalInterest componentSignalInterest(enum_t sig) const
+    {
+        if (!isSignalDesired(sig)) {
+            return SignalInterest::NONE;
+        }
+        return isSignalConsumed(sig) ? SignalInterest::CONSUMED
+                                     : SignalInterest::SHARED;
+    }
+
     /// A concrete Component must implement
     /// this method, where it will return
     /// true for any signal of interest. This includes
@@ -84,6 +113,18 @@ public:
     /// purposes.
     virtual bool isSignalDesired(enum_t sig) const = 0;
 
+    /// A concrete Component may override this method to opt into
+    /// first-match semantics: return true for a desired signal that
+    /// no later component (in container declaration order) should
+    /// receive. Like isSignalDesired(), the answer must not change
+    /// once the component is started, as the container consults it
+    /// only once, when building its routing table.
+    virtual bool isSignalConsumed(enum_t sig) const
+    {
+        static_cast<void>(sig);
+        return false;
+    }
+
 protected:
     /// A concrete Component must implement
     /// this method, where it will subscribe
@@ -28,30 +28,43 @@
 
 #include <array>
 #include <tuple>
+#include <utility>
 #include "cmsOrthogonalComponent.hpp"
+#include "cmsOrthogonalSignalRouter.hpp"
 
 namespace cms {
 
 /// The OrthogonalContainer, which is a QP::QActive and a variadic template
 /// class, will take 'N' OrthogonalComponents as a template parameter
-/// pack. Each parameter must be derived from OrthogonalComponent
-/// and each must implement a move constructor.
+/// pack. Each parameter must be derived from OrthogonalComponent or
+/// StaticOrthogonalComponent, and must be constructible from the
+/// containing QP::QActive pointer. Components are constructed in place,
+/// so no copy or move constructor is required.
+///
+/// Once the components have started, the container builds a signal
+/// routing table (see OrthogonalSignalRouter) from each component's
+/// isSignalDesired() and isSignalConsumed() answers. Each event is then
+/// dispatched only to the components interested in it, in template
+/// parameter order.
 ///
 /// See the associated tests (orthogonalContainerTests.cpp) for examples of
 /// how to use/create/start a concrete container.
 ///
-/// \tparam Components - the OrthogonalComponent derived classes to be
-///                      instantiated and managed by this OrthogonalContainer
+/// \tparam Components - the OrthogonalComponent (or StaticOrthogonalComponent)
+///                      derived classes to be instantiated and managed by
+///                      this OrthogonalContainer
 template <typename... Components>
 class OrthogonalContainer : public QP::QActive {
 public:
     static constexpr std::size_t NumberOfComponents = sizeof...(Components);
     static_assert(NumberOfComponents >= 1, "zero components not supported");
 
-    using Tuple = std::tuple<Components...>;
+    using Tuple  = std::tuple<Components...>;
+    using Router = OrthogonalSignalRouter<NumberOfComponents>;
 
     explicit OrthogonalContainer() :
-        QP::QActive(Q_STATE_CAST(initial)), m_components(Components {this}...)
+        QP::QActive(Q_STATE_CAST(initial)),
+        m_components(ContainerFor<Components>()...), m_router()
     {
     }
 
@@ -78,6 +91,11 @@ protected:
     {
         ForEachInTuple(me->m_components,
                        [](auto& component) { component.start(); });
+        me->m_router.build(NumberOfComponents,
+                           [me](std::size_t index, enum_t sig) {
+                               return SignalInterestAt(me->m_components,
+                                                       index, sig);
+                           });
         return me->tran(Q_STATE_CAST(&running));
     }
 
@@ -92,11 +110,9 @@ protected:
                 rtn = Q_HANDLED();
                 break;
             default: {
-                bool handled = false;
-                ForEachInTuple(me->m_components,
-                               [e, &handled](auto& component) {
-                                   handled |= component.componentDispatch(e);
-                               });
+                bool handled = me->m_router.isRouted(e->sig)
+                                 ? me->routedDispatch(e)
+                                 : me->scanDispatch(e);
 
                 if (handled) {
                     rtn = Q_HANDLED();
@@ -110,7 +126,85 @@ protected:
     }
 
 private:
+    // One container pointer per component, forwarded by the std::tuple
+    // constructor directly into each element's constructor. No temporary
+    // component is created, so no component is ever moved.
+    template <typename>
+    QP::QActive* ContainerFor()
+    {
+        return this;
+    }
+
+    using ComponentInterest = SignalInterest (*)(Tuple const&, enum_t);
+    using ComponentDispatch = void (*)(Tuple&, QP::QEvt const*);
+
+    template <std::size_t I>
+    static SignalInterest InterestAt(Tuple const& components, enum_t sig)
+    {
+        return std::get<I>(components).componentSignalInterest(sig);
+    }
+
+    template <std::size_t I>
+    static void DispatchAt(Tuple& components, QP::QEvt const* const e)
+    {
+        std::get<I>(components).componentDispatchRouted(e);
+    }
+
+    template <std::size_t... Is>
+    static constexpr std::array<ComponentInterest, NumberOfComponents>
+    MakeInterestTable(std::index_sequence<Is...>)
+    {
+        return {{&InterestAt<Is>...}};
+    }
+
+    template <std::size_t... Is>
+    static constexpr std::array<ComponentDispatch, NumberOfComponents>
+    MakeDispatchTable(std::index_sequence<Is...>)
+    {
+        return {{&DispatchAt<Is>...}};
+    }
+
+    static SignalInterest SignalInterestAt(Tuple const& components,
+                                           std::size_t index, enum_t sig)
+    {
+        static constexpr auto table =
+          MakeInterestTable(std::index_sequence_for<Components...>());
+        return table[index](components, sig);
+    }
+
+    bool routedDispatch(QP::QEvt const* const e)
+    {
+        static constexpr auto table =
+          MakeDispatchTable(std::index_sequence_for<Components...>());
+
+        typename Router::Mask mask = m_router.route(e->sig);
+        Router::ForEachRouted(mask, [this, e](std::size_t index) {
+            table[index](m_components, e);
+        });
+        return mask != 0U;
+    }
+
+    // fallback for signals beyond the routing table
+    bool scanDispatch(QP::QEvt const* const e)
+    {
+        bool handled  = false;
+        bool consumed = false;
+        ForEachInTuple(m_components, [e, &handled, &consumed](auto& component) {
+            if (!consumed) {
+                SignalInterest interest =
+                  component.componentSignalInterest(e->sig);
+                if (interest != SignalInterest::NONE) {
+                    component.componentDispatchRouted(e);
+                    handled  = true;
+                    consumed = (interest == SignalInterest::CONSUMED);
+                }
+            }
+        });
+        return handled;
+    }
+
     Tuple m_components;
+    Router m_router;
 };
 
 }   // namespace cms
@@ -0,0 +1,129 @@
+/// @brief Signal routing table for orthogonal component containers.
+///        Maps each signal to the set of components interested in it.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_ORTHOGONAL_SIGNAL_ROUTER_HPP
+#define CMS_ORTHOGONAL_SIGNAL_ROUTER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "cmsOrthogonalComponent.hpp"
+
+/// Signals below this value are routed through a table built when
+/// the container starts. Signals at or above it fall back to asking
+/// each component in turn. Override from the build if a project's
+/// component signals extend beyond the default.
+#ifndef CMS_ORTHOGONAL_ROUTED_SIGNALS
+    #define CMS_ORTHOGONAL_ROUTED_SIGNALS 64
+#endif
+
+namespace cms {
+
+/// The OrthogonalSignalRouter holds one bit mask per routed signal,
+/// with bit 'i' set when component 'i' of the container processes
+/// that signal. The table is built once, after the components have
+/// started, so per-event dispatch no longer asks every component.
+///
+/// \tparam MaxComponents - the most components the container may hold.
+template <std::size_t MaxComponents>
+class OrthogonalSignalRouter {
+public:
+    static_assert(MaxComponents >= 1, "zero components not supported");
+    static_assert(MaxComponents <= 32, "at most 32 components are supported");
+
+    static constexpr enum_t RoutedSignals = CMS_ORTHOGONAL_ROUTED_SIGNALS;
+    static_assert(RoutedSignals > 0, "routing table must not be empty");
+
+    using Mask = std::conditional_t<
+      (MaxComponents <= 8U), std::uint8_t,
+      std::conditional_t<(MaxComponents <= 16U), std::uint16_t,
+                         std::uint32_t>>;
+
+    OrthogonalSignalRouter() : m_routes(), m_isBuilt(false)
+    {
+        m_routes.fill(0U);
+    }
+
+    /// Build the routing table.
+    /// \param componentCount - number of components in the container.
+    /// \param query - callable as query(index, sig), returning the
+    ///                SignalInterest of component 'index' in 'sig'.
+    ///                A CONSUMED answer ends the search for that signal.
+    template <class Query>
+    void build(std::size_t componentCount, Query query)
+    {
+        for (enum_t sig = 0; sig < RoutedSignals; ++sig) {
+            std::uint32_t bits = 0U;
+            if (sig >= QP::Q_USER_SIG) {
+                for (std::size_t i = 0U; i < componentCount; ++i) {
+                    SignalInterest interest = query(i, sig);
+                    if (interest != SignalInterest::NONE) {
+                        bits |= (std::uint32_t {1U} << i);
+                    }
+                    if (interest == SignalInterest::CONSUMED) {
+                        break;
+                    }
+                }
+            }
+            m_routes[static_cast<std::size_t>(sig)] = static_cast<Mask>(bits);
+        }
+        m_isBuilt = true;
+    }
+
+    /// \return true if 'sig' can be dispatched using route()
+    bool isRouted(enum_t sig) const
+    {
+        return m_isBuilt && (sig >= 0) && (sig < RoutedSignals);
+    }
+
+    /// \return the components interested in 'sig'. Only valid
+    ///         when isRouted(sig) is true.
+    Mask route(enum_t sig) const
+    {
+        return m_routes[static_cast<std::size_t>(sig)];
+    }
+
+    /// Call func(index) for each component set in 'mask', lowest
+    /// index first.
+    template <class F>
+    static void ForEachRouted(Mask mask, F func)
+    {
+        std::uint32_t bits = mask;
+        for (std::size_t i = 0U; bits != 0U; ++i) {
+            if ((bits & 1U) != 0U) {
+                func(i);
+            }
+            bits >>= 1U;
+        }
+    }
+
+private:
+    std::array<Mask, static_cast<std::size_t>(RoutedSignals)> m_routes;
+    bool m_isBuilt;
+};
+
+}   // namespace cms
+
+#endif   // CMS_ORTHOGONAL_SIGNAL_ROUTER_HPP
@@ -26,6 +26,10 @@
 
 #include "CppUTestExt/MockSupport.h"
 #include "qsafe.h"
+#include "qassert-meta.h"
+#include <cstddef>
+#include <cstdio>
+#include <type_traits>
 
 namespace cms {
 namespace test {
@@ -36,6 +40,22 @@ static constexpr const char* ONERROR_FUNC_NAME  = "Q_onError";
 void QAssertMetaOutputEnable();
 void QAssertMetaOutputDisable();
 
+/// Report an assert and abort(), instead of the cpputest mock call and
+/// test exit. For use outside of a cpputest test run, such as fuzzing.
+void QAssertAbortEnable();
+
+/// Look up the qassert-meta description of (module, id), through the
+/// same index used by Q_onError. Each distinct key searches the
+/// qassert-meta tables once; later lookups are a hash probe. The index
+/// keeps its own copy of 'module', which may be any string.
+/// \return true if a description exists, copied to 'meta' if not null.
+bool QAssertMetaFind(const char* module, int id, QAssertMetaDescription* meta);
+
+/// Print (module, id) and its qassert-meta description to 'out', as
+/// Q_onError does: the full description the first time each indexed key
+/// is printed, then a pointer back to it.
+void QAssertMetaPrint(std::FILE* out, const char* module, int id);
+
 inline void MockExpectQAssert()
 {
     //if we are formally expecting an assert,
@@ -59,7 +79,66 @@ inline void MockExpectQAssert(const char* module, int id)
       .withParameter("id", id);
 }
 
+#if defined(__unix__) || defined(__APPLE__)
+#define CMS_QASSERT_DEATH_TEST_SUPPORTED 1
+
+/// Outcome of running a body in a forked child, see RunForQAssertDeath.
+struct QAssertDeathResult {
+    static constexpr std::size_t MODULE_MAX = 64;
+
+    bool asserted;                  ///< the child reached Q_onError
+    bool threw;                     ///< the body threw in the child
+    char module[MODULE_MAX];        ///< module reported to Q_onError
+    int id;                         ///< id reported to Q_onError
+};
+
+using QAssertDeathBody = void (*)(void* context);
+
+/// Run 'body' in a child process forked from the current state of the
+/// test, i.e. after setup() and anything the test has already done.
+/// In the child, Q_onError reports (module, id) to this process and
+/// exits immediately, so asserts raised inside noexcept QP functions
+/// (which would otherwise std::terminate the test runner) may be
+/// tested. The child shares nothing back: state changes made by 'body'
+/// are not visible to the test afterwards.
+///
+/// Do not use CHECK macros or mocks inside 'body': their outcome would be
+/// lost with the child. A body which throws (including a failed CHECK,
+/// where cpputest fails by exception) ends the child with 'threw' set.
+QAssertDeathResult RunForQAssertDeath(QAssertDeathBody body, void* context);
+
+template <class Func>
+QAssertDeathResult RunForQAssertDeath(Func&& func)
+{
+    return RunForQAssertDeath(
+      [](void* context) {
+          (*static_cast<typename std::remove_reference<Func>::type*>(
+            context))();
+      },
+      static_cast<void*>(&func));
+}
+
+#endif   // unix
+
 }   // namespace test
 }   // namespace cms
 
+#ifdef CMS_QASSERT_DEATH_TEST_SUPPORTED
+
+/// Expect 'statement' to QASSERT with (module, id). The statement runs
+/// in a forked child, see cms::test::RunForQAssertDeath().
+#define CMS_EXPECT_QASSERT_DEATH(module_, id_, statement)                   \
+    do {                                                                    \
+        cms::test::QAssertDeathResult cmsDeathResult_ =                     \
+          cms::test::RunForQAssertDeath([&]() { statement; });              \
+        CHECK_FALSE_TEXT(cmsDeathResult_.threw,                             \
+                         "threw in the death test child: " #statement);     \
+        CHECK_TRUE_TEXT(cmsDeathResult_.asserted,                           \
+                        "expected a QASSERT from: " #statement);            \
+        STRCMP_EQUAL((module_), cmsDeathResult_.module);                    \
+        LONGS_EQUAL((id_), cmsDeathResult_.id);                             \
+    } while (0)
+
+#endif   // CMS_QASSERT_DEATH_TEST_SUPPORTED
+
 #endif   // QASSERT_MOCK_SUPPORT_HPP
@@ -0,0 +1,118 @@
+/// @brief Orthogonal component with compile time (CRTP) dispatch. See
+///        Samek, Chapter 5, section 5.4 Orthogonal Component.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_STATIC_ORTHOGONAL_COMPONENT_HPP
+#define CMS_STATIC_ORTHOGONAL_COMPONENT_HPP
+
+#include <cassert>
+#include <cstdint>
+#include "qpcpp.hpp"
+#include "cms_cpputest_state_coverage.hpp"
+#include "cmsOrthogonalComponent.hpp"
+
+namespace cms {
+
+/// The StaticOrthogonalComponent class is a CRTP alternative to
+/// OrthogonalComponent. The signals of interest are a template parameter
+/// list, so isSignalDesired() is a constexpr comparison chain the compiler
+/// may fold into a switch, and the OrthogonalContainer dispatches to it
+/// without any virtual calls. Both kinds of component may be mixed in
+/// the same container.
+///
+/// The Derived class must provide a `void subscribe()` member reachable
+/// from this base (public, or befriend the base), and may provide
+/// `static constexpr bool isSignalConsumed(enum_t sig)` to opt into
+/// first-match semantics (see OrthogonalComponent::isSignalConsumed).
+///
+/// \tparam Derived - the concrete component class.
+/// \tparam DesiredSigs - every signal the component processes: published,
+///                       posted to the container, or used by its timers.
+template <class Derived, enum_t... DesiredSigs>
+class StaticOrthogonalComponent : public QP::QHsm {
+public:
+    static_assert(sizeof...(DesiredSigs) >= 1, "no desired signals listed");
+
+    explicit StaticOrthogonalComponent(QP::QActive* container,
+                                       QP::QStateHandler const initial,
+                                       std::uint_fast8_t const qs_id = 0) :
+        QP::QHsm(initial),
+        m_container(container), m_qs_id(qs_id)
+    {
+    }
+
+    StaticOrthogonalComponent(const StaticOrthogonalComponent&) = delete;
+    StaticOrthogonalComponent&
+    operator=(const StaticOrthogonalComponent&) = delete;
+    StaticOrthogonalComponent(StaticOrthogonalComponent&&) = delete;
+    StaticOrthogonalComponent&
+    operator=(StaticOrthogonalComponent&& other) = delete;
+
+    void start()
+    {
+        assert(m_container != nullptr);
+        static_cast<Derived*>(this)->subscribe();
+        QP::QHsm::init(nullptr, m_qs_id);
+    }
+
+    bool componentDispatch(QP::QEvt const* const e)
+    {
+        bool desired = isSignalDesired(e->sig);
+        if (desired) {
+            componentDispatchRouted(e);
+        }
+        return desired;
+    }
+
+    void componentDispatchRouted(QP::QEvt const* const e)
+    {
+        assert(m_container != nullptr);
+        CMS_STATE_COVERAGE_RECORD(this, e);
+        QP::QHsm::dispatch(e, m_qs_id);
+    }
+
+    SignalInterest componentSignalInterest(enum_t sig) const
+    {
+        if (!isSignalDesired(sig)) {
+            return SignalInterest::NONE;
+        }
+        return Derived::isSignalConsumed(sig) ? SignalInterest::CONSUMED
+                                              : SignalInterest::SHARED;
+    }
+
+    static constexpr bool isSignalDesired(enum_t sig)
+    {
+        return ((sig == DesiredSigs) || ...);
+    }
+
+    /// Default: no first-match semantics. A Derived class may hide this.
+    static constexpr bool isSignalConsumed(enum_t) { return false; }
+
+protected:
+    QP::QActive* m_container;
+    std::uint_fast8_t m_qs_id;
+};
+
+}   // namespace cms
+
+#endif   // CMS_STATIC_ORTHOGONAL_COMPONENT_HPP
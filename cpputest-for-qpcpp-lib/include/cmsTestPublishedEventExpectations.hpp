@@ -0,0 +1,156 @@
+/// @brief Expectations matched against published events as they arrive.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_TEST_PUBLISHED_EVENT_EXPECTATIONS_HPP
+#define CMS_TEST_PUBLISHED_EVENT_EXPECTATIONS_HPP
+
+#include "qpcpp.hpp"
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace cms {
+namespace test {
+
+/// Expected published event sequences, declared up front and matched one
+/// event at a time as a PublishedEventRecorder receives them (see
+/// PublishedEventRecorder::streamTo()), so a long scenario is checked
+/// without storing its events. Each expectation keeps a fixed amount of
+/// matching state, whatever the length of the run.
+///
+/// The first mismatch fails the running test (unless constructed with
+/// failFast false), with the event and the expectation it broke.
+/// Matching then stops. A mismatch found while QF dispatches to the
+/// recorder fails the test once the dispatch returns, from
+/// qf_ctrl::ProcessEvents() or MoveTimeForward(), so QF's dispatch is
+/// never cut short. Call verify() at the end of the test for
+/// expectations still incomplete.
+///
+///     PublishedEventExpectations expect;
+///     expect.inOrder({CONNECT_SIG, {DATA_SIG, IsFirstBlock}, CLOSE_SIG})
+///       .unordered({LED_ON_SIG, BEEP_SIG}, 100ms)
+///       .countWithin(HEARTBEAT_SIG, 9, 11, 10s);
+///     recorder->streamTo(&expect);
+///     ... run the scenario ...
+///     expect.verify();
+class PublishedEventExpectations {
+public:
+    using Predicate = std::function<bool(QP::QEvt const* e)>;
+
+    /// one expected event: its signal and, optionally, a payload predicate.
+    struct Step {
+        /// implicit, so a signal alone is a step
+        Step(enum_t sig_) : sig(sig_), matches() {}
+        Step(enum_t sig_, Predicate matches_) :
+            sig(sig_), matches(std::move(matches_))
+        {
+        }
+
+        bool Matches(QP::QEvt const* e) const;
+
+        enum_t sig;
+        Predicate matches;   ///< none to match any event with 'sig'
+    };
+
+    /// the most steps of an unordered() expectation
+    static constexpr size_t MAX_UNORDERED_STEPS = 32U;
+
+    explicit PublishedEventExpectations(bool failFast = true);
+
+    PublishedEventExpectations(const PublishedEventExpectations&) = delete;
+    PublishedEventExpectations&
+    operator=(const PublishedEventExpectations&) = delete;
+
+    /// The events published with the steps' signals arrive as the steps,
+    /// in order. Events with other signals are ignored, as are the steps'
+    /// signals once the sequence is complete.
+    PublishedEventExpectations& inOrder(std::initializer_list<Step> steps);
+
+    /// Each step arrives, in any order, within 'window' of the first of
+    /// them. Repeats of a step already seen are ignored.
+    PublishedEventExpectations& unordered(std::initializer_list<Step> steps,
+                                          std::chrono::milliseconds window);
+
+    /// 'sig' is published at least 'min' and at most 'max' times within
+    /// 'period' from now (per qf_ctrl::Now()).
+    PublishedEventExpectations& countWithin(enum_t sig, uint32_t min,
+                                            uint32_t max,
+                                            std::chrono::milliseconds period);
+
+    /// every event published with 'sig' satisfies 'predicate'.
+    PublishedEventExpectations& always(enum_t sig, Predicate predicate);
+
+    /// match one published event, as PublishedEventRecorder does.
+    void onEvent(QP::QEvt const* e);
+
+    /// fail the running test if any expectation failed or is incomplete.
+    void verify();
+
+    /// \return true once an expectation failed, see failure().
+    bool hasFailed() const { return m_failed; }
+
+    /// \return the first failure's description, empty if none.
+    const char* failure() const { return m_failure.data(); }
+
+    /// \return the events matched so far.
+    uint32_t eventCount() const { return m_eventCount; }
+
+private:
+    enum class Kind : uint8_t { IN_ORDER, UNORDERED, COUNT_WITHIN, ALWAYS };
+
+    struct Expectation {
+        Kind kind;
+        std::vector<Step> steps;
+        std::chrono::milliseconds duration;   ///< window or period
+        std::chrono::milliseconds start;
+        size_t next;         ///< IN_ORDER: the next step
+        uint32_t seen;       ///< UNORDERED: mask of the steps seen
+        uint32_t count;      ///< COUNT_WITHIN: events in the period
+        uint32_t min;
+        uint32_t max;
+    };
+
+    void Match(size_t index, Expectation& expectation, QP::QEvt const* e,
+               std::chrono::milliseconds now);
+    void Fail(size_t index, QP::QEvt const* e, const char* format, ...)
+#if defined(__GNUC__)
+      __attribute__((format(printf, 4, 5)))
+#endif
+      ;
+
+    std::vector<Expectation> m_expectations;
+    std::array<char, 256> m_failure;
+    uint32_t m_eventCount;
+    bool m_failFast;
+    bool m_failed;
+};
+
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_TEST_PUBLISHED_EVENT_EXPECTATIONS_HPP
@@ -26,9 +26,19 @@
 #define CMS_TEST_PUBLISHED_EVENT_RECORDER_HPP
 
 #include "cmsDummyActiveObject.hpp"
+#include "cmsTestPublishedEventExpectations.hpp"
 #include "cmsVectorBackedQEQueue.hpp"
 #include "qevtUniquePtr.hpp"
 #include "qpcpp.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace cms {
 namespace test {
@@ -38,12 +48,42 @@ namespace test {
 /// Uses the DummyActiveObject signal callback handler to record
 /// desired signals received for the purpose of host PC based
 /// unit testing.
+///
+/// Signals published at high rates may instead be counted, see
+/// countSignals(): the recorder then neither subscribes to them nor
+/// stores them, keeping only a count, the time last seen and optionally
+/// a copy of the last event.
 class PublishedEventRecorder final : public DefaultDummyActiveObject {
+public:
+    struct SignalCount {
+        uint64_t count;
+        std::chrono::milliseconds lastSeen;
+    };
+
 private:
+    struct CountedRange {
+        enum_t startingValue;
+        enum_t endValue;
+        size_t valueSize;   // 0 if the last event is not kept
+        std::vector<SignalCount> counts;
+        std::vector<std::max_align_t> values;
+        std::vector<size_t> copiedSizes;   // of each last event kept
+
+        size_t ValueStride() const
+        {
+            return (valueSize + sizeof(std::max_align_t) - 1U) /
+                   sizeof(std::max_align_t);
+        }
+    };
+
     const enum_t m_startingValue;
     const enum_t m_endValue;
     cms::VectorBackedQEQueue m_recordedEvents;
     enum_t m_oneShotIgnoreSig;
+    bool m_isStarted;
+    std::vector<CountedRange> m_countedRanges;
+    QP::TrafficTap m_countingTap;
+    PublishedEventExpectations* m_expectations;
 
 public:
     static PublishedEventRecorder*
@@ -70,12 +110,17 @@ public:
                                     size_t maxRecordedEventCount = 100) :
         DummyActiveObject(), m_startingValue(startingValue),
         m_endValue(endValue), m_recordedEvents(maxRecordedEventCount),
-        m_oneShotIgnoreSig(0)
+        m_oneShotIgnoreSig(0), m_isStarted(false), m_countedRanges(),
+        m_countingTap{&CountingTapOnPublish, nullptr, nullptr, this},
+        m_expectations(nullptr)
     {
     }
 
     ~PublishedEventRecorder() override
     {
+        if (!m_countedRanges.empty()) {
+            QP::RemoveTrafficTap(&m_countingTap);
+        }
         while (!m_recordedEvents.isEmpty()) {
             const auto e = m_recordedEvents.get(0);
             QP::QF::gc(e);
@@ -93,9 +138,78 @@ public:
           [=](QP::QEvt const* e) { this->RecorderEventHandler(e); });
 
         dummyStart(priority);
+        m_isStarted = true;
 
         for (enum_t sig = m_startingValue; sig < m_endValue; ++sig) {
-            subscribe(sig);
+            if (findCountedRange(sig) == nullptr) {
+                subscribe(sig);
+            }
+        }
+    }
+
+    /// Count the events published in the signal range
+    ///         [startingValue ... endValue)
+    /// instead of recording them, before or after recorderStart(). The
+    /// recorder observes publishes with a QP::TrafficTap rather than
+    /// subscribing, so counted events take no recorder queue space and
+    /// return to their pool as soon as any real subscribers are done.
+    void countSignals(enum_t startingValue, enum_t endValue)
+    {
+        addCountedRange(startingValue, endValue, 0U);
+    }
+
+    /// As countSignals(), also keeping a copy of the last event published
+    /// with each signal of the range, each of which must be an EvtT.
+    template <class EvtT>
+    void countSignalsKeepingLast(enum_t startingValue, enum_t endValue)
+    {
+        static_assert(std::is_base_of<QP::QEvt, EvtT>::value,
+                      "EvtT must be a QP::QEvt");
+        static_assert(std::is_trivially_copyable<EvtT>::value,
+                      "the last EvtT is kept as a copy");
+        static_assert(alignof(EvtT) <= alignof(std::max_align_t),
+                      "EvtT is over aligned");
+        addCountedRange(startingValue, endValue, sizeof(EvtT));
+    }
+
+    /// \return the count of a counted signal and when it was last seen
+    ///         (per qf_ctrl::Now()), a zero count if not counted.
+    SignalCount getSignalCount(enum_t sig) const
+    {
+        CountedRange const* range = findCountedRange(sig);
+        if (range == nullptr) {
+            return {0U, std::chrono::milliseconds(0)};
+        }
+        return range->counts[static_cast<size_t>(sig - range->startingValue)];
+    }
+
+    /// \return a copy of the last event counted with 'sig', nullptr if
+    ///         none yet, the signal was not counted with
+    ///         countSignalsKeepingLast<EvtT>() or the last event was
+    ///         smaller than an EvtT. Valid until the next publish of 'sig'.
+    template <class EvtT> EvtT const* getLastCountedEvent(enum_t sig) const
+    {
+        CountedRange const* range = findCountedRange(sig);
+        if ((range == nullptr) || (range->valueSize < sizeof(EvtT))) {
+            return nullptr;
+        }
+
+        const auto index = static_cast<size_t>(sig - range->startingValue);
+        if ((range->counts[index].count == 0U) ||
+            (range->copiedSizes[index] < sizeof(EvtT))) {
+            return nullptr;
+        }
+        return reinterpret_cast<EvtT const*>(
+          &range->values[index * range->ValueStride()]);
+    }
+
+    /// zero the counts of all counted signals.
+    void resetSignalCounts()
+    {
+        for (auto& range : m_countedRanges) {
+            for (auto& count : range.counts) {
+                count = {0U, std::chrono::milliseconds(0)};
+            }
         }
     }
 
@@ -132,6 +246,81 @@ public:
         m_oneShotIgnoreSig = sigToIgnore;
     }
 
+    /// Match each event received against 'expectations' as it arrives,
+    /// rather than recording it, so a long scenario needs no storage in
+    /// proportion to its length. nullptr to record events again.
+    void streamTo(PublishedEventExpectations* expectations)
+    {
+        m_expectations = expectations;
+    }
+
+private:
+    void addCountedRange(enum_t startingValue, enum_t endValue,
+                         size_t valueSize)
+    {
+        assert(startingValue < endValue);
+        for (enum_t sig = startingValue; sig < endValue; ++sig) {
+            assert(findCountedRange(sig) == nullptr);
+        }
+
+        if (m_countedRanges.empty()) {
+            const bool added = QP::AddTrafficTap(&m_countingTap);
+            assert(added);
+            static_cast<void>(added);
+        }
+
+        const auto signals = static_cast<size_t>(endValue - startingValue);
+        CountedRange range{startingValue, endValue, valueSize, {}, {}, {}};
+        range.counts.assign(signals, {0U, std::chrono::milliseconds(0)});
+        range.values.resize(signals * range.ValueStride());
+        range.copiedSizes.assign(signals, 0U);
+        m_countedRanges.push_back(std::move(range));
+
+        if (m_isStarted) {
+            for (enum_t sig = startingValue; sig < endValue; ++sig) {
+                if ((sig >= m_startingValue) && (sig < m_endValue)) {
+                    unsubscribe(sig);
+                }
+            }
+        }
+    }
+
+    CountedRange const* findCountedRange(enum_t sig) const
+    {
+        for (auto const& range : m_countedRanges) {
+            if ((sig >= range.startingValue) && (sig < range.endValue)) {
+                return &range;
+            }
+        }
+        return nullptr;
+    }
+
+    static void CountingTapOnPublish(void* context, QP::QEvt const* e,
+                                     void const* /*sender*/)
+    {
+        auto me = static_cast<PublishedEventRecorder*>(context);
+        const enum_t sig = e->sig;
+        for (auto& range : me->m_countedRanges) {
+            if ((sig < range.startingValue) || (sig >= range.endValue)) {
+                continue;
+            }
+
+            const auto index = static_cast<size_t>(sig - range.startingValue);
+            SignalCount& count = range.counts[index];
+            ++count.count;
+            count.lastSeen = qf_ctrl::Now();
+            if (range.valueSize != 0U) {
+                // never read past the end of a smaller event
+                const size_t size =
+                  std::min(range.valueSize, QP::GetEventSize(e));
+                std::memcpy(&range.values[index * range.ValueStride()], e,
+                            size);
+                range.copiedSizes[index] = size;
+            }
+            return;
+        }
+    }
+
 protected:
     void RecorderEventHandler(QP::QEvt const* e) override
     {
@@ -139,6 +328,9 @@ protected:
             if (e->sig == m_oneShotIgnoreSig) {
                 m_oneShotIgnoreSig = 0;
             }
+            else if (m_expectations != nullptr) {
+                m_expectations->onEvent(e);
+            }
             else {
                 // record the event
                 m_recordedEvents.post(e, QP::QF::NO_MARGIN, 0);
@@ -0,0 +1,94 @@
+/// @brief A QTimeEvt alternative backed by a hierarchical timing wheel.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_WHEEL_TIME_EVT_HPP
+#define CMS_WHEEL_TIME_EVT_HPP
+
+#include <cstdint>
+#include "qpcpp.hpp"
+
+namespace cms {
+
+class TimingWheel;
+
+/// A time event with the armX()/disarm()/rearm() semantics of
+/// QP::QTimeEvt, kept in a hierarchical timing wheel rather than in QP's
+/// list of armed time events. Each QP::QTimeEvt::tick() visits every armed
+/// QTimeEvt, while a tick of the wheel costs in proportion to the time
+/// events expiring, so tests of active objects holding thousands of armed
+/// timers (such as per connection timeouts) stay fast.
+///
+/// The wheel is ticked by qf_ctrl::MoveTimeForward(), at tick rate 0,
+/// after QTimeEvt::tick(). Active objects select it for unit tests with
+/// a type alias, e.g.
+///
+///     #ifdef UNIT_TEST
+///     using TimeEvt = cms::WheelTimeEvt;
+///     #else
+///     using TimeEvt = QP::QTimeEvt;
+///     #endif
+class WheelTimeEvt : public QP::QEvt {
+public:
+    /// \param tickRate - only tick rate 0 is supported.
+    WheelTimeEvt(QP::QActive* act, QP::QSignal sig,
+                 std::uint_fast8_t tickRate = 0U) noexcept;
+    ~WheelTimeEvt();
+
+    WheelTimeEvt(const WheelTimeEvt&)            = delete;
+    WheelTimeEvt& operator=(const WheelTimeEvt&) = delete;
+    WheelTimeEvt(WheelTimeEvt&&)                 = delete;
+    WheelTimeEvt& operator=(WheelTimeEvt&&)      = delete;
+
+    /// Arm to be posted 'nTicks' ticks from now, then every 'interval'
+    /// ticks if not 0. Must not already be armed.
+    void armX(std::uint32_t nTicks, std::uint32_t interval = 0U) noexcept;
+
+    /// \return true if the time event was armed (and is now disarmed).
+    bool disarm() noexcept;
+
+    /// Arm to be posted 'nTicks' ticks from now, keeping the interval.
+    /// \return true if the time event was armed.
+    bool rearm(std::uint32_t nTicks) noexcept;
+
+    bool isArmed() const noexcept;
+
+    /// \return ticks until the time event is posted, 0 if not armed.
+    std::uint32_t getCtr() const noexcept;
+
+    QP::QActive* getAct() const noexcept { return m_act; }
+
+private:
+    friend class TimingWheel;
+
+    QP::QActive* m_act;
+    WheelTimeEvt* m_next;
+    WheelTimeEvt* m_prev;
+    WheelTimeEvt** m_slot;   ///< list holding the armed time event
+    std::uint64_t m_expiry;  ///< absolute tick of the next post
+    std::uint32_t m_interval;
+    std::uint32_t m_epoch;   ///< wheel epoch the time event was armed in
+};
+
+}   // namespace cms
+
+#endif   // CMS_WHEEL_TIME_EVT_HPP
@@ -0,0 +1,85 @@
+/// @brief Capture and replay of the external stimulus applied to
+///        active objects under test.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_CAPTURE_HPP
+#define CMS_CPPUTEST_QF_CAPTURE_HPP
+
+#include <cstddef>
+#include "qpcpp.hpp"
+
+namespace cms {
+namespace test {
+namespace qf_ctrl {
+
+/// Begin logging every stimulus applied through qf_ctrl to a binary
+/// file: PostAndProcess(), PublishEvent() (and PublishAndProcess()),
+/// ProcessEvents(), MoveTimeForward() (as ticks), and qf_ctrl timeline
+/// stimuli, along with the payload bytes of each posted or published
+/// event. After each stimulus a hash of the resulting dispatches (active
+/// object priority and signal) is logged, so a replay can confirm it
+/// reproduced the same behavior, including every published event
+/// delivered to its subscribers.
+///
+/// Payload size is the event's pool block size. Static (non pool) events
+/// are logged as a plain QEvt unless their size is provided with
+/// RegisterCaptureEventSize().
+///
+/// The file is in host byte order, for replay on the same kind of host.
+/// \param path - file to create or overwrite.
+/// \return false if the file could not be created.
+bool StartCapture(const char* path);
+
+/// Provide the size of static events using 'sig', so their payload
+/// is captured. Valid until StopCapture().
+void RegisterCaptureEventSize(enum_t sig, size_t eventSize);
+
+/// Finish the capture and close the file.
+/// \return true if every record was written.
+bool StopCapture();
+
+/// \return true between StartCapture() and StopCapture().
+bool IsCapturing();
+
+struct ReplayResult {
+    bool loaded;           ///< the file was opened and is a well formed
+                           ///< capture of the started active objects
+    bool matched;          ///< every dispatch trace matched the capture
+    size_t records;        ///< records replayed
+    size_t checks;         ///< dispatch traces compared
+    size_t mismatchRecord; ///< 1 based record of the first mismatch, or 0
+};
+
+/// Replay a capture as fast as possible. Setup() and start the same
+/// active objects, at the same priorities, as when the capture began.
+/// Replay stops at the first dispatch trace mismatch, and at the first
+/// malformed record or post to a priority with no active object, which
+/// clear 'loaded'.
+/// \param path - a file created by StartCapture().
+ReplayResult Replay(const char* path);
+
+}   // namespace qf_ctrl
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_CAPTURE_HPP
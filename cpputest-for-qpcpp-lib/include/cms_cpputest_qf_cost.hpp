@@ -0,0 +1,114 @@
+/// @brief Simulated CPU cost model and response time report.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_COST_HPP
+#define CMS_CPPUTEST_QF_COST_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "qpcpp.hpp"
+
+#ifndef CMS_COST_MAX_DECLARED
+#define CMS_COST_MAX_DECLARED 128U
+#endif
+
+namespace cms {
+namespace test {
+namespace cost {
+
+using Microseconds = std::chrono::microseconds;
+
+/// Charge each dispatch's cost to a simulated CPU, as if the system ran
+/// on the target. The CPU runs dispatches one after another: a dispatch
+/// starts once the CPU is free, but no earlier than qf_ctrl::Now() when
+/// it is dispatched. Its response time is measured from qf_ctrl::Now()
+/// to the end of the dispatch, so work overrunning a clock tick adds to
+/// the response times of the next tick's dispatches, and Backlog() grows
+/// across ticks when the CPU is overloaded.
+///
+/// While the CPU is busy (Backlog() is not 0), qf_ctrl holds back both
+/// dispatch and clock ticks: ProcessEvents() leaves events queued, and
+/// MoveTimeForward() only advances qf_ctrl::Now(). The first tick at
+/// which the CPU is free runs the held ticks, so time events fire late,
+/// then dispatches every queued event. Events posted meanwhile wait in
+/// their queues, which fill as they would on an overloaded target, and
+/// POST_X() fails once too little of a queue is left. A held event's
+/// response time is measured from when it is finally dispatched.
+///
+/// Enable() clears all statistics; declared costs and deadlines remain
+/// until Clear(). qf_ctrl::Teardown() calls Disable().
+void Enable();
+void Disable();
+bool IsEnabled();
+
+/// Declare the target's cost for 'ao' to handle 'sig' (any active object
+/// if 'ao' is nullptr). Costs declared for a specific active object take
+/// precedence.
+/// \return false if CMS_COST_MAX_DECLARED costs are already declared.
+bool DeclareCost(QP::QActive const* ao, enum_t sig, Microseconds cost);
+
+/// Handlers without a declared cost are charged their host execution
+/// time multiplied by 'scale', such as the target's speed relative to
+/// the host. The default scale of 0 charges them nothing.
+void SetMeasuredScale(double scale);
+
+/// Count dispatches to 'ao' whose response time exceeds 'deadline'.
+void SetDeadline(QP::QActive const* ao, Microseconds deadline);
+
+/// Name an active object for reports.
+void NameActiveObject(QP::QActive const* ao, const char* name);
+
+/// Forget all declared costs, deadlines and names.
+void Clear();
+
+struct ActiveObjectStats {
+    uint32_t dispatches;
+    uint32_t deadlineMisses;
+    Microseconds busy;            ///< total cost charged
+    Microseconds worstResponse;
+    enum_t worstResponseSig;      ///< signal of the worst response
+    Microseconds deadline;        ///< 0 if none
+};
+
+/// \return false if 'ao' was never dispatched to since Enable().
+bool GetStats(QP::QActive const* ao, ActiveObjectStats* stats);
+
+/// \return total cost charged since Enable().
+Microseconds Busy();
+
+/// \return how far the simulated CPU is behind qf_ctrl::Now(), 0 when
+///         it is keeping up.
+Microseconds Backlog();
+
+/// Write, for each active object dispatched to, its dispatches, busy
+/// time, worst response time (with its signal) and deadline misses,
+/// followed by the CPU load.
+void Report(std::FILE* out);
+
+}   // namespace cost
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_COST_HPP
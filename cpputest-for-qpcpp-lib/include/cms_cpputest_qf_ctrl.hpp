@@ -77,12 +77,14 @@ void Teardown();
 
 /// During a unit test, call this function to "give CPU time"
 /// to the QF subsystem.
+/// \note does nothing while the cost model's simulated CPU is busy,
+///       see cms_cpputest_qf_cost.hpp.
 void ProcessEvents();
 
 /// During a unit test, call this function to "move time forward."
 /// Internally, this executes the QF framework's tick function
 /// the appropriate number of times to simulate the forward
-/// movement of time.
+/// movement of time, applying any scheduled stimuli as they fall due.
 /// \param duration - how many milliseconds of time should be simulated
 void MoveTimeForward(const std::chrono::milliseconds &duration);
 
@@ -109,11 +111,7 @@ void PublishAndProcess(QP::QEvt const * e,
 /// followed internally by ProcessEvents().
 /// \param e
 /// \param dest
-inline void PostAndProcess(QP::QEvt const * e, QP::QActive* dest)
-{
-    dest->POST(e, nullptr);
-    ProcessEvents();
-}
+void PostAndProcess(QP::QEvt const * e, QP::QActive* dest);
 
 /// Helper method to Post a static const QEvt to an active object
 /// followed internally by ProcessEvents().
@@ -126,6 +124,111 @@ inline void PostAndProcess(QP::QActive* dest)
     PostAndProcess(&constEvent, dest);
 }
 
+/// \return simulated time since Setup(), advanced by MoveTimeForward().
+std::chrono::milliseconds Now();
+
+/// \return clock ticks run since Setup().
+uint64_t TicksSinceSetup();
+
+/// A stimulus to apply at a future simulated time, see At(), After()
+/// and Every(). A stimulus falls due at the first tick at or after its
+/// time. Due stimuli are applied once that tick's own events (such as
+/// timeouts) are processed, in time order and then in the order they
+/// were scheduled, followed by ProcessEvents().
+class ScheduledStimulus {
+public:
+    /// Post 'e' to 'dest'. Periodic stimuli require a static event.
+    void Post(QP::QActive* dest, QP::QEvt const* e);
+
+    /// Post a newly allocated QEvt with 'sig' to 'dest'.
+    void Post(QP::QActive* dest, enum_t sig);
+
+    /// Publish 'e'. Periodic stimuli require a static event.
+    void Publish(QP::QEvt const* e);
+
+    /// Publish a newly allocated QEvt with 'sig'.
+    void Publish(enum_t sig);
+
+private:
+    friend ScheduledStimulus At(const std::chrono::milliseconds& time);
+    friend ScheduledStimulus Every(const std::chrono::milliseconds& period);
+
+    ScheduledStimulus(uint64_t dueTick, uint64_t periodTicks) :
+        m_dueTick(dueTick), m_periodTicks(periodTicks)
+    {
+    }
+
+    uint64_t m_dueTick;
+    uint64_t m_periodTicks;   // 0 for a single stimulus
+};
+
+/// Schedule a stimulus at 'time' since Setup(), e.g.
+///     qf_ctrl::At(std::chrono::seconds(5)).Post(ao, &evt);
+ScheduledStimulus At(const std::chrono::milliseconds& time);
+
+/// Schedule a stimulus 'delay' from Now().
+ScheduledStimulus After(const std::chrono::milliseconds& delay);
+
+/// Schedule a stimulus every 'period', starting one period from Now(),
+/// until Teardown() or ClearTimeline(), e.g.
+///     qf_ctrl::Every(std::chrono::milliseconds(100)).Publish(sig);
+ScheduledStimulus Every(const std::chrono::milliseconds& period);
+
+/// \return the number of scheduled stimuli not yet applied (a periodic
+///         stimulus counts once).
+size_t PendingStimuli();
+
+/// Drop all scheduled stimuli, recycling any pool events they hold.
+void ClearTimeline();
+
+/// \return the number of pub/sub pool events currently allocated,
+///         including any pool overflow events (cms_cpputest_qf_pool_overflow.hpp).
+size_t PoolEventsInUse();
+
+/// A block of test owned memory to capture in a Checkpoint, such as
+/// an active object and its event queue storage.
+struct MemoryRegion {
+    void* address;
+    size_t size;
+};
+
+using MemoryRegions = std::vector<MemoryRegion>;
+
+template <class T>
+inline MemoryRegion RegionOf(T& object)
+{
+    return MemoryRegion {static_cast<void*>(&object), sizeof(T)};
+}
+
+/// Capture the current QF state: the ready set, the active object
+/// registry, subscriber lists, time event lists, the virtual clock
+/// (Now()) and scheduled stimuli, and the bytes of each provided region.
+/// A later test in the same TEST_GROUP may then call Restore() right
+/// after Setup(), instead of replaying an expensive preamble. Replaces
+/// any prior checkpoint.
+///
+/// Requirements:
+///  - all pub/sub event pool blocks, and any pool overflow events, are
+///    free (ProcessEvents() first). The test fails otherwise.
+///  - every object QF refers to (active objects, queue storage, time
+///    events) lives at the same address for as long as the checkpoint
+///    is in use, e.g. static storage, and is passed in 'userRegions'.
+///  - regions must not own heap memory that changes after capture.
+///  - scheduled stimuli post or publish static events, or allocate
+///    their event when due (the pools being free).
+/// \param userRegions - test owned memory to capture and restore.
+void Checkpoint(const MemoryRegions& userRegions = {});
+
+/// Return QF and the captured regions to the state at Checkpoint().
+/// Call after Setup() with the same arguments used for the checkpoint.
+void Restore();
+
+/// \return true if a checkpoint was captured by the current TEST_GROUP.
+bool HasCheckpoint();
+
+/// Release the checkpoint, if any.
+void DiscardCheckpoint();
+
 /// Get the internal library version string.
 /// Uses semantic versioning.
 const char * GetVersion();
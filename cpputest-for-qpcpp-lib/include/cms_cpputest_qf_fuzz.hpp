@@ -0,0 +1,108 @@
+/// @brief Fuzzing harness driving active objects through qf_ctrl.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_FUZZ_HPP
+#define CMS_CPPUTEST_QF_FUZZ_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+
+namespace cms {
+namespace test {
+namespace fuzz {
+
+/// A signal the fuzzer may post or publish, with the size of its
+/// event type. Bytes beyond the QEvt header are taken from the input.
+struct FuzzSignal {
+    enum_t sig;
+    size_t eventSize;
+};
+
+struct FuzzTarget {
+    enum_t maxPubSubSignalValue;   ///< as for qf_ctrl::Setup()
+    uint32_t ticksPerSecond;       ///< as for qf_ctrl::Setup()
+
+    /// start the active objects under test, which must live in static
+    /// storage and be included in 'regions'.
+    void (*startActiveObjects)();
+    qf_ctrl::MemoryRegions regions;
+
+    QP::QActive* postTarget;   ///< receives posted signals
+    std::vector<FuzzSignal> postSignals;
+    std::vector<FuzzSignal> publishSignals;
+    uint16_t maxTimeStepMs;   ///< largest single time advance
+};
+
+enum class InputResult {
+    OK,
+    POOL_LEAK   ///< pool events still allocated once the system was idle
+};
+
+/// Setup QF, start the target's active objects, and checkpoint the
+/// result. Each input is then run from that checkpoint, reset with
+/// qf_ctrl::Restore() rather than a Setup()/Teardown() cycle.
+void Initialize(const FuzzTarget& target);
+
+/// Decode and apply one input. The input is a sequence of operations,
+/// each starting with an operation byte (taken modulo 4):
+///  0: post:    an index byte selecting from postSignals, then the
+///              event's payload bytes. Posts use a margin, so a full
+///              queue drops the event rather than asserting.
+///  1: publish: as post, selecting from publishSignals. The published
+///              event is processed immediately.
+///  2: time:    two bytes (little endian) of milliseconds, modulo
+///              maxTimeStepMs + 1, passed to qf_ctrl::MoveTimeForward().
+///  3: process: qf_ctrl::ProcessEvents().
+/// A truncated operation ends the input; events are then processed
+/// and the pools checked for leaks.
+InputResult RunOneInput(const uint8_t* data, size_t size);
+
+/// As RunOneInput(), but abort() on a finding, for use as the body of
+/// LLVMFuzzerTestOneInput(). Link with cpputest-for-qpcpp-fuzz-lib and
+/// call cms::test::QAssertAbortEnable() once, so assertions are reported
+/// as crashes:
+///
+///     extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data,
+///                                           size_t size)
+///     {
+///         static const bool initialized = []() {
+///             cms::test::QAssertAbortEnable();
+///             cms::test::fuzz::Initialize(MakeFuzzTarget());
+///             return true;
+///         }();
+///         return cms::test::fuzz::TestOneInput(data, size);
+///     }
+/// \return 0
+int TestOneInput(const uint8_t* data, size_t size);
+
+/// Release the checkpoint and Teardown() QF.
+void Shutdown();
+
+}   // namespace fuzz
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_FUZZ_HPP
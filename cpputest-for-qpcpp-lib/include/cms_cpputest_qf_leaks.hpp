@@ -0,0 +1,89 @@
+/// @brief Pool event leak tracking: where each live event was allocated.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_LEAKS_HPP
+#define CMS_CPPUTEST_QF_LEAKS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "qpcpp.hpp"
+
+/// Live blocks tracked at once, a power of two. Allocations beyond
+/// three quarters of it are counted, but not tracked.
+#ifndef CMS_LEAK_TRACKING_CAPACITY
+#define CMS_LEAK_TRACKING_CAPACITY 4096U
+#endif
+
+/// Define CMS_LEAK_TRACKING_BACKTRACE to also record the allocating call
+/// stack (glibc backtrace()), at a far higher cost per allocation.
+#ifndef CMS_LEAK_TRACKING_BACKTRACE_DEPTH
+#define CMS_LEAK_TRACKING_BACKTRACE_DEPTH 12U
+#endif
+
+namespace cms {
+namespace test {
+namespace leaks {
+
+/// Where a pool event still in use was allocated.
+struct LiveBlock {
+    void const* block;
+    uint64_t tick;       ///< qf_ctrl::TicksSinceSetup() at the allocation
+    uint32_t sequence;   ///< allocations since qf_ctrl::Setup(), from 1
+    uint8_t poolNum;     ///< QF's pool number, from 1
+    uint8_t prio;        ///< the allocating active object, 0 for the test
+#ifdef CMS_LEAK_TRACKING_BACKTRACE
+    uint8_t frameCount;
+    void* frames[CMS_LEAK_TRACKING_BACKTRACE_DEPTH];
+#endif
+};
+
+/// Track pool event allocations until Disable(). qf_ctrl::Setup() forgets
+/// the blocks tracked by the previous test, and when built with
+/// CMS_ENABLE_POOL_LEAK_TRACKING, enables tracking for every test.
+/// qf_ctrl::Teardown() reports the live blocks of a leaking test.
+void Enable();
+void Disable();
+bool IsEnabled();
+
+/// \return the tracked events still in use.
+size_t LiveCount();
+
+/// \return the tracked events still in use with signal 'sig'.
+size_t LiveCount(enum_t sig);
+
+/// \return the allocations not tracked, the table being full.
+size_t UntrackedCount();
+
+/// \return the live block holding 'e', nullptr if not tracked.
+LiveBlock const* Find(QP::QEvt const* e);
+
+/// Write the live blocks grouped by signal and allocating active object,
+/// with the first allocation of each group.
+void Report(std::FILE* out);
+
+}   // namespace leaks
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_LEAKS_HPP
@@ -0,0 +1,94 @@
+/// @brief Pool event lifetime and queueing delay histograms, by signal.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_LIFETIME_HPP
+#define CMS_CPPUTEST_QF_LIFETIME_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "qpcpp.hpp"
+
+/// Pool events stamped at once, a power of two. Allocations beyond
+/// three quarters of it are counted, but not stamped.
+#ifndef CMS_LIFETIME_CAPACITY
+#define CMS_LIFETIME_CAPACITY 4096U
+#endif
+
+namespace cms {
+namespace test {
+namespace lifetime {
+
+/// A log2 histogram: bucket 0 counts zeros, bucket b the values in
+/// [2^(b-1), 2^b), and the last bucket every larger value.
+struct Histogram {
+    static constexpr size_t BUCKETS = 40U;
+
+    std::array<uint64_t, BUCKETS> buckets;
+    uint64_t count;
+    uint64_t sum;
+    uint64_t max;
+
+    void Add(uint64_t value);
+
+    /// \return an upper bound of the given percentile (0 to 100) of the
+    ///         values, the top of its bucket; 0 if none.
+    uint64_t Percentile(double percent) const;
+};
+
+/// The stamps of one signal's pool events. A lifetime runs from the
+/// allocation (QF_EPOOL_GET_) to the final recycle (QF_EPOOL_PUT_). A
+/// queueing delay runs from the allocation to the first dispatch, and
+/// from each dispatch to the next, so time spent in a deferral queue
+/// counts too. Each is kept in simulated ticks and in host nanoseconds.
+struct SignalLifetimes {
+    Histogram lifetimeTicks;
+    Histogram lifetimeNs;
+    Histogram queueTicks;
+    Histogram queueNs;
+};
+
+/// Stamp each pool event until Disable(). The histograms add up across
+/// tests until Reset(). qf_ctrl::Setup() forgets the stamps of events
+/// left by the previous test.
+void Enable();
+void Disable();
+bool IsEnabled();
+void Reset();
+
+/// \return the histograms of 'sig', nullptr if none of its pool events
+///         were stamped.
+SignalLifetimes const* Find(enum_t sig);
+
+/// \return the allocations not stamped, the table being full.
+size_t UnstampedCount();
+
+/// Write a line per signal, longest worst queueing delay first.
+void Report(std::FILE* out);
+
+}   // namespace lifetime
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_LIFETIME_HPP
@@ -0,0 +1,100 @@
+/// @brief Per test cost metrics: wall time, QF traffic and peak usage.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_METRICS_HPP
+#define CMS_CPPUTEST_QF_METRICS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "CppUTest/TestPlugin.h"
+
+#ifndef CMS_METRICS_MAX_TEST_RECORDS
+#define CMS_METRICS_MAX_TEST_RECORDS 16384U
+#endif
+
+/// A test simulating at least CMS_METRICS_IDLE_TICKS_MIN ticks, of which
+/// fewer than one in CMS_METRICS_IDLE_TICKS_RATIO dispatched any event,
+/// is flagged as simulating far more ticks than it needs.
+#ifndef CMS_METRICS_IDLE_TICKS_MIN
+#define CMS_METRICS_IDLE_TICKS_MIN 10000U
+#endif
+
+#ifndef CMS_METRICS_IDLE_TICKS_RATIO
+#define CMS_METRICS_IDLE_TICKS_RATIO 100U
+#endif
+
+namespace cms {
+namespace test {
+namespace metrics {
+
+/// The cost of one test.
+struct TestMetrics {
+    double seconds;         ///< wall time, including setup() and teardown()
+    uint64_t dispatched;    ///< events dispatched to active objects
+    uint64_t published;     ///< events published
+    uint64_t ticks;         ///< ticks simulated, over every qf_ctrl::Setup()
+    uint64_t activeTicks;   ///< of those, ticks which dispatched any event
+    size_t poolPeak;        ///< most pool events in use at once
+    size_t queuePeak;       ///< most events queued at once, on any one
+                            ///< active object
+    bool idleTicks;         ///< flagged, see CMS_METRICS_IDLE_TICKS_MIN
+};
+
+/// Start measuring a test, forgetting any test measured before.
+void BeginTest();
+
+/// \return the metrics of the test measured since BeginTest().
+TestMetrics Current();
+
+/// Record the test measured since BeginTest(), keeping the first
+/// CMS_METRICS_MAX_TEST_RECORDS tests.
+void EndTest(const char* group, const char* name);
+
+/// Forget the recorded tests.
+void Reset();
+
+/// Write the recorded tests as a JSON object: "tests", most costly (wall
+/// time) first, and "suite" totals, including the tests flagged for
+/// simulating mostly idle ticks.
+void ReportJson(std::FILE* out);
+
+/// Measures and records each test. cpputestMain.cpp installs it when
+/// CMS_TEST_METRICS_REPORT names a file for ReportJson().
+class MetricsPlugin : public TestPlugin {
+public:
+    MetricsPlugin();
+    ~MetricsPlugin() override;
+
+    MetricsPlugin(const MetricsPlugin&)            = delete;
+    MetricsPlugin& operator=(const MetricsPlugin&) = delete;
+
+    void preTestAction(UtestShell& test, TestResult& result) override;
+    void postTestAction(UtestShell& test, TestResult& result) override;
+};
+
+}   // namespace metrics
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_METRICS_HPP
@@ -0,0 +1,71 @@
+/// @brief Opt in overflow of exhausted event pools into a secondary slab.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_POOL_OVERFLOW_HPP
+#define CMS_CPPUTEST_QF_POOL_OVERFLOW_HPP
+
+#include <cstddef>
+#include <cstdio>
+
+#ifndef CMS_POOL_OVERFLOW_DEFAULT_BYTES
+#define CMS_POOL_OVERFLOW_DEFAULT_BYTES (64U * 1024U)
+#endif
+
+namespace cms {
+namespace test {
+namespace overflow {
+
+/// Overflow of one pool, as ordered in qf_ctrl::Setup()'s MemPoolConfigs.
+struct PoolStats {
+    size_t blockSize;    ///< the pool's block size, 0 if it never overflowed
+    size_t overflows;    ///< events the pool could not supply
+    size_t liveBlocks;   ///< overflow events still in use
+    size_t peakBlocks;   ///< most overflow events in use at once, the
+                         ///< extra demand on the pool
+};
+
+/// Opt in, after qf_ctrl::Setup() and until qf_ctrl::Teardown(): an event
+/// an exhausted pool can not supply without a margin (Q_NEW()) comes from
+/// a secondary slab of 'arenaBytes', rather than failing QF's assertion,
+/// so a test may run to the end and report the pool size it needed.
+/// QF::gc() returns each event to the allocator which supplied it, and the
+/// teardown leak check covers both. Overflow beyond the arena fails QF's
+/// assertion as before.
+void Enable(size_t arenaBytes = CMS_POOL_OVERFLOW_DEFAULT_BYTES);
+bool IsEnabled();
+
+/// \return the overflow of the pool at 'poolIndex', from 0.
+PoolStats GetStats(size_t poolIndex);
+
+/// \return the overflow events still in use, across all pools.
+size_t LiveBlocks();
+
+/// Write each pool which overflowed, with its peak extra demand.
+/// qf_ctrl::Teardown() writes this to stderr for a test which overflowed.
+void Report(std::FILE* out);
+
+}   // namespace overflow
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_POOL_OVERFLOW_HPP
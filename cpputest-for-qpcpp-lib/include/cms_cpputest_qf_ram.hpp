@@ -0,0 +1,94 @@
+/// @brief RAM footprint report for the QF configuration under test.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_RAM_HPP
+#define CMS_CPPUTEST_QF_RAM_HPP
+
+#include <cstddef>
+#include <cstdio>
+#include "qpcpp.hpp"
+
+#ifndef CMS_RAM_MAX_TEST_RECORDS
+#define CMS_RAM_MAX_TEST_RECORDS 16384U
+#endif
+
+namespace cms {
+namespace test {
+namespace ram {
+
+/// RAM used by the QF configuration under test, in bytes.
+///
+/// Time events are only counted within the declared size of the active
+/// object they are members of. Time events held elsewhere, such as at
+/// file scope or in a test fixture, are not counted even while armed:
+/// QF lists a time event only while it is armed, and the list does not
+/// tell whether it lies within an active object already counted.
+struct Footprint {
+    size_t poolBytes;           ///< pub/sub event pool storage
+    size_t subscriberBytes;     ///< subscriber lists, one per pub/sub signal
+    size_t queueBytes;          ///< started active objects' queue storage
+    size_t activeObjectBytes;   ///< declared active object sizes, which
+                                ///< include their time events
+    size_t frameworkBytes;      ///< QF registry, ready set and time event heads
+    size_t activeObjects;       ///< started active objects
+    size_t undeclaredActiveObjects;   ///< of those, without a declared size
+
+    size_t Total() const
+    {
+        return poolBytes + subscriberBytes + queueBytes + activeObjectBytes +
+               frameworkBytes;
+    }
+};
+
+/// Declare the size of an active object, which QF can not see. The
+/// declaration lasts until qf_ctrl::Teardown().
+void DeclareActiveObjectSize(QP::QActive const* ao, size_t size);
+
+template <class T>
+void DeclareActiveObject(T const* ao)
+{
+    DeclareActiveObjectSize(ao, sizeof(T));
+}
+
+/// \return the footprint of the configuration set up by qf_ctrl::Setup()
+///         and the active objects started since, all zero outside Setup().
+Footprint Measure();
+
+/// qf_ctrl::Teardown() records each test's footprint, for the reports
+/// below, keeping the first CMS_RAM_MAX_TEST_RECORDS and the largest.
+/// Forget those records.
+void Reset();
+
+/// Write each recorded test's footprint, then the suite's largest
+/// footprint and the test which needed it.
+void ReportText(std::FILE* out);
+
+/// As ReportText(), as a JSON object with "tests" and "suite" members,
+/// for tracking per commit.
+void ReportJson(std::FILE* out);
+
+}   // namespace ram
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_RAM_HPP
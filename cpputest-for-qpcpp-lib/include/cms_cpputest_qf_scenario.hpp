@@ -0,0 +1,125 @@
+/// @brief Scenario runner applying text scenario files through qf_ctrl.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_SCENARIO_HPP
+#define CMS_CPPUTEST_QF_SCENARIO_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "qpcpp.hpp"
+
+namespace cms {
+namespace test {
+namespace scenario {
+
+/// Create and start an active object named by a scenario. Active objects
+/// must use priorities above qf_ctrl::RECORDER_PRIORITY.
+using ActiveObjectFactory = QP::QActive* (*)();
+
+/// Release an active object created by its factory.
+using ActiveObjectDestroyer = void (*)(QP::QActive* ao);
+
+constexpr size_t MAX_ACTIVE_OBJECTS = 16;
+constexpr size_t MAX_SIGNALS        = 256;
+
+/// Settings passed to qf_ctrl::Setup() before each scenario.
+void Configure(enum_t maxPubSubSignalValue, uint32_t ticksPerSecond);
+
+/// Register an active object for scenarios to 'start' by 'name'.
+/// 'name' must outlive the registration (typically a string literal).
+/// \return false if the name is taken or the registry is full.
+bool RegisterActiveObject(const char* name, ActiveObjectFactory create,
+                          ActiveObjectDestroyer destroy);
+
+/// Register a signal for scenarios to refer to by 'name'.
+/// \return false if the name is taken or the registry is full.
+bool RegisterSignal(const char* name, enum_t sig);
+
+/// Forget all registered active objects and signals.
+void ClearRegistry();
+
+struct RunSummary {
+    size_t files;             ///< files run
+    size_t unreadableFiles;   ///< files which could not be loaded
+    size_t scenarios;
+    size_t passed;
+    size_t failed;
+    size_t steps;             ///< steps applied, over all scenarios
+    double seconds;           ///< host time spent running scenarios
+};
+
+/// Run the scenarios in 'text', one step per line:
+///
+///     # a comment
+///     scenario <name>
+///       start <active object>
+///       post <active object> <signal>
+///       publish <signal>
+///       advance <time>[ms|s]
+///       expect <signal>
+///       expect-none
+///     end
+///
+/// Each scenario runs between qf_ctrl::Setup() and qf_ctrl::Teardown(),
+/// with a PublishedEventRecorder recording all published signals.
+/// 'expect' consumes the oldest published event not yet expected, which
+/// must carry 'signal'. 'expect-none' requires that none remain.
+/// A scenario fails at its first failing step, an unknown name, or pool
+/// events still allocated at its end; failures are written to 'log'
+/// (if not nullptr) as "<source>:<line>: <scenario>: <reason>".
+/// Lines are parsed in place, without allocation.
+RunSummary RunText(const char* text, size_t length, const char* source,
+                   FILE* log);
+
+/// As RunText(), for a file read through memory-mapped I/O where
+/// available.
+RunSummary RunFile(const char* path, FILE* log);
+
+/// Write a one line summary, such as:
+///     scenarios: 1200 passed: 1199 failed: 1 steps: 9600 in 210.3 ms
+void Report(const RunSummary& summary, FILE* out);
+
+/// A runner main(): run each file named on the command line, writing
+/// failures and the summary to stdout. Register active objects and
+/// signals and call Configure() first, then link with the library
+/// without a main() (cpputest-for-qpcpp-fuzz-lib):
+///
+///     int main(int argc, char* argv[])
+///     {
+///         cms::test::scenario::Configure(MAX_PUB_SIG, TICKS_PER_SECOND);
+///         cms::test::scenario::RegisterSignal("BUTTON_SIG", BUTTON_SIG);
+///         cms::test::scenario::RegisterActiveObject(
+///           "Light", &CreateLight, &DestroyLight);
+///         return cms::test::scenario::RunMain(argc, argv);
+///     }
+///
+/// Assertions abort the run, see cms::test::QAssertAbortEnable().
+/// \return EXIT_SUCCESS if every file was read and every scenario passed.
+int RunMain(int argc, char* argv[]);
+
+}   // namespace scenario
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_SCENARIO_HPP
@@ -0,0 +1,112 @@
+/// @brief Runtime statistics of the fake QF port, since qf_ctrl::Setup().
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_STATS_HPP
+#define CMS_CPPUTEST_QF_STATS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "qpcpp.hpp"
+
+/// Hooks used by the port and qf_ctrl. Compiled out, along with every
+/// counter, unless CMS_ENABLE_QF_STATS is defined (see the CMake option
+/// of the same name).
+#ifdef CMS_ENABLE_QF_STATS
+#define CMS_QF_STATS_DISPATCH(prio_) ::cms::test::qf_ctrl::StatsOnDispatch((prio_))
+#define CMS_QF_STATS_PUBLISH() ::cms::test::qf_ctrl::StatsOnPublish()
+#define CMS_QF_STATS_DELIVERY() ::cms::test::qf_ctrl::StatsOnDelivery()
+#define CMS_QF_STATS_POST() ::cms::test::qf_ctrl::StatsOnPost()
+#define CMS_QF_STATS_POOL_GET(poolNum_) ::cms::test::qf_ctrl::StatsOnPoolGet((poolNum_))
+#define CMS_QF_STATS_POOL_PUT(poolNum_) ::cms::test::qf_ctrl::StatsOnPoolPut((poolNum_))
+#define CMS_QF_STATS_TICK() ::cms::test::qf_ctrl::StatsOnTick()
+#define CMS_QF_STATS_SCHEDULER_PASS() ::cms::test::qf_ctrl::StatsOnSchedulerPass()
+#else
+#define CMS_QF_STATS_DISPATCH(prio_) (static_cast<void>(0))
+#define CMS_QF_STATS_PUBLISH() (static_cast<void>(0))
+#define CMS_QF_STATS_DELIVERY() (static_cast<void>(0))
+#define CMS_QF_STATS_POST() (static_cast<void>(0))
+#define CMS_QF_STATS_POOL_GET(poolNum_) (static_cast<void>(0))
+#define CMS_QF_STATS_POOL_PUT(poolNum_) (static_cast<void>(0))
+#define CMS_QF_STATS_TICK() (static_cast<void>(0))
+#define CMS_QF_STATS_SCHEDULER_PASS() (static_cast<void>(0))
+#endif
+
+namespace cms {
+namespace test {
+namespace qf_ctrl {
+
+/// \return true if built with CMS_ENABLE_QF_STATS; otherwise every
+///         QfStats counter stays 0.
+constexpr bool StatsEnabled()
+{
+#ifdef CMS_ENABLE_QF_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// Counters since Setup() or ResetStats().
+struct QfStats {
+    /// events dispatched, by active object priority
+    std::array<uint64_t, QF_MAX_ACTIVE + 1U> dispatched;
+    uint64_t publishes;    ///< PUBLISH() calls
+    uint64_t deliveries;   ///< subscribers QF posted those publishes to
+    uint64_t posts;        ///< other POST() and POST_X() calls
+    /// pool events allocated and freed, by pool index, from 0
+    std::array<uint64_t, QF_MAX_EPOOL> allocations;
+    std::array<uint64_t, QF_MAX_EPOOL> frees;
+    uint64_t ticks;             ///< clock ticks processed
+    uint64_t schedulerPasses;   ///< active objects chosen to run by
+                                ///< RunUntilNoReadyActiveObjects()
+
+    /// \return the events dispatched to all active objects.
+    uint64_t TotalDispatched() const
+    {
+        uint64_t total = 0;
+        for (auto count : dispatched) {
+            total += count;
+        }
+        return total;
+    }
+};
+
+QfStats GetStats();
+void ResetStats();
+
+// the hooks behind the CMS_QF_STATS_ macros above
+void StatsOnDispatch(std::uint_fast8_t prio);
+void StatsOnPublish();
+void StatsOnDelivery();
+void StatsOnPost();
+void StatsOnPoolGet(std::uint_fast8_t poolNum);
+void StatsOnPoolPut(std::uint_fast8_t poolNum);
+void StatsOnTick();
+void StatsOnSchedulerPass();
+
+}   // namespace qf_ctrl
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_STATS_HPP
@@ -0,0 +1,93 @@
+/// @brief (state handler, signal) dispatch coverage for QP state machines.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_STATE_COVERAGE_HPP
+#define CMS_CPPUTEST_STATE_COVERAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include "qpcpp.hpp"
+
+#ifndef CMS_STATE_COVERAGE_MAX_STATES
+#define CMS_STATE_COVERAGE_MAX_STATES 256U
+#endif
+
+#ifndef CMS_STATE_COVERAGE_MAX_SIGNALS
+#define CMS_STATE_COVERAGE_MAX_SIGNALS 64U
+#endif
+
+/// Hook used by the port event loop and the orthogonal components.
+/// Compiled out unless CMS_ENABLE_STATE_COVERAGE is defined (see the
+/// CMake option of the same name).
+#ifdef CMS_ENABLE_STATE_COVERAGE
+#define CMS_STATE_COVERAGE_RECORD(machine_, e_)                      \
+    ::cms::test::coverage::Record((machine_), (machine_)->state(), (e_)->sig)
+#else
+#define CMS_STATE_COVERAGE_RECORD(machine_, e_) (static_cast<void>(0))
+#endif
+
+namespace cms {
+namespace test {
+namespace coverage {
+
+/// Record that 'sig' was dispatched to 'machine' while in 'state',
+/// the current (leaf) state handler. One saturating 8 bit counter per
+/// (state, signal) pair, in a fixed map with no heap use. Signals at or
+/// above CMS_STATE_COVERAGE_MAX_SIGNALS, and states beyond
+/// CMS_STATE_COVERAGE_MAX_STATES, are counted as dropped.
+void Record(QP::QAsm const* machine, QP::QStateHandler state,
+            QP::QSignal sig);
+
+/// Clear all counters. State slots, and so counter positions, are kept
+/// for the life of the process.
+void Reset();
+
+/// \return true if 'sig' was dispatched while in 'state'.
+bool IsCovered(QP::QStateHandler state, enum_t sig);
+
+/// \return the number of distinct (state, signal) pairs recorded.
+size_t CoveredPairs();
+
+/// \return the number of records dropped for lack of map capacity.
+size_t Dropped();
+
+/// The raw counter map, CMS_STATE_COVERAGE_MAX_SIGNALS counters per
+/// state slot, e.g. as feedback for a fuzzer. With
+/// CMS_STATE_COVERAGE_LIBFUZZER_COUNTERS defined, the map is placed in
+/// libFuzzer's extra counters section and used automatically.
+const uint8_t* Counters();
+size_t CountersSize();
+
+/// Name a state for reports.
+void NameState(QP::QStateHandler state, const char* name);
+
+/// Write the coverage matrix: for each state machine (by the first
+/// instance seen), each state and the signals dispatched to it.
+void Report(std::FILE* out);
+
+}   // namespace coverage
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_STATE_COVERAGE_HPP
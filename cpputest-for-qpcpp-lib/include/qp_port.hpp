@@ -5,6 +5,7 @@
 #ifndef CPPUTEST_FOR_QPCPP_LIB_QP_PORT_HPP
 #define CPPUTEST_FOR_QPCPP_LIB_QP_PORT_HPP
 
+#include <cstddef>
 #include <cstdint>    // Exact-width types. C++11 Standard
 
 #ifdef QP_CONFIG
@@ -43,17 +44,189 @@ namespace QP {
 
 void RunUntilNoReadyActiveObjects();
 
+/// How RunUntilNoReadyActiveObjects() orders dispatching.
+enum class SchedulingPolicy : std::uint8_t {
+    /// dispatch every queued event of the highest priority ready active
+    /// object before choosing again (the port's original behavior).
+    DRAIN_QUEUE,
+
+    /// as the QV kernel: dispatch one event per scheduling decision.
+    QV,
+
+    /// as the QK kernel: as QV, and an event posted during a dispatch
+    /// preempts that dispatch (runs to completion at the point of the post)
+    /// if the receiver's priority is above the running active object's
+    /// preemption threshold. Posts from the test itself, as from an ISR,
+    /// wait for processing.
+    QK
+};
+
+/// \return the event queue length given to QActive::start() by the active
+///         object at 'prio', 0 if none is started there.
+std::uint_fast16_t GetQueueLength(std::uint_fast8_t prio);
+
+/// \return the bytes of 'e' which may be read: its pool's block size, or
+///         sizeof(QEvt) for an event not from a pool, whose size QF does
+///         not know.
+std::size_t GetEventSize(QEvt const* e);
+
+/// A block of this port's own per active object state.
+struct PortStateRegion {
+    void* address;
+    std::size_t size;
+};
+
+/// \return the port's per active object state (queue lengths and
+///         preemption thresholds), for test support which captures and
+///         restores QF state, e.g. qf_ctrl::Checkpoint().
+std::array<PortStateRegion, 2> GetPortStateRegions();
+
+/// Select the scheduling policy. QF::init() (qf_ctrl::Setup()) restores
+/// SchedulingPolicy::DRAIN_QUEUE.
+void SetSchedulingPolicy(SchedulingPolicy policy);
+SchedulingPolicy GetSchedulingPolicy();
+
+/// \return the priority of the active object whose event is being
+///         dispatched, 0 while the test itself runs.
+std::uint_fast8_t GetActivePriority();
+
+/// Observe each event dispatched by this port's event loop, for test
+/// support features such as trace capture. Either callback may be nullptr.
+struct DispatchObserver {
+    void (*beforeDispatch)(void* context, QActive const* act, QEvt const* e);
+    void (*afterDispatch)(void* context, QActive const* act, QEvt const* e);
+    void* context;
+};
+
+/// \return false if CPPUTEST_MAX_DISPATCH_OBSERVERS are already added.
+bool AddDispatchObserver(DispatchObserver const* observer);
+void RemoveDispatchObserver(DispatchObserver const* observer);
+
+/// Observe the event pool blocks QF takes (after the get) and returns
+/// (before the put), for test support features such as leak tracking.
+/// 'poolNum' is QF's pool number, from 1. Either callback may be nullptr.
+struct PoolObserver {
+    void (*onGet)(void* context, std::uint_fast8_t poolNum, void const* block);
+    void (*onPut)(void* context, std::uint_fast8_t poolNum, void const* block);
+    void* context;
+};
+
+/// \return false if CPPUTEST_MAX_POOL_OBSERVERS are already added.
+bool AddPoolObserver(PoolObserver const* observer);
+void RemovePoolObserver(PoolObserver const* observer);
+
+/// A secondary allocator for events a pool can not supply without a
+/// margin (Q_NEW()), in place of QF's assertion. 'put' returns false for
+/// a block it did not supply, which then returns to the pool.
+struct PoolOverflow {
+    void* (*get)(void* context, std::uint_fast8_t poolNum,
+                 std::uint_fast16_t blockSize);
+    bool (*put)(void* context, std::uint_fast8_t poolNum, void* block);
+    void* context;
+};
+
+/// Set the pool overflow allocator, nullptr for none (QF::init()).
+void SetPoolOverflow(PoolOverflow const* overflow);
+
+/// \return the events published with PUBLISH() since the program started.
+std::uint64_t GetPublishCount();
+
+/// Observe all event traffic without subscribing to it: each PUBLISH(),
+/// each POST() and POST_X() (including QF's post of a published event to
+/// each subscriber), and each event an active object takes from its queue.
+/// A tap keeps no reference to the events it sees, so observing changes
+/// neither scheduling nor pool usage. Any callback may be nullptr.
+struct TrafficTap {
+    void (*onPublish)(void* context, QEvt const* e, void const* sender);
+    /// 'delivery' is true for QF's post of a published event to a subscriber.
+    /// The receiver is not known here: the port sees the arguments of
+    /// POST() and POST_X(), not the active object they are invoked on.
+    /// onReceive() later reports the same event with its receiver.
+    void (*onPost)(void* context, QEvt const* e, void const* sender,
+                   bool delivery);
+    /// 'receiver' is about to dispatch 'e'
+    void (*onReceive)(void* context, QActive const* receiver, QEvt const* e);
+    void* context;
+};
+
+/// \return false if CPPUTEST_MAX_TRAFFIC_TAPS are already added.
+bool AddTrafficTap(TrafficTap const* tap);
+void RemoveTrafficTap(TrafficTap const* tap);
+
+// inform each TrafficTap, called only while one is added
+extern std::size_t cpputest_trafficTapCount_;
+void cpputest_tapPublish_(QEvt const* e, void const* sender);
+void cpputest_tapPost_(QEvt const* e, void const* sender);
+
+#ifdef CMS_ENABLE_QF_STATS
+// count a publish or post, see cms_cpputest_qf_stats.hpp
+void cpputest_statsOnPublish_();
+void cpputest_statsOnPost_();
+#endif
+
+// PUBLISH(), POST() and POST_X() are redefined below to pass each event
+// through here on its way to QF.
+extern std::uint64_t cpputest_publishCount_;
+
+// true while QF's publish_() POST()s to the subscribers, but not while
+// an active object preempts it (see RunReadyAbove()).
+extern bool cpputest_publishing_;
+
+// a temporary in PUBLISH(), ending the publish once publish_() returns
+struct cpputest_PublishScope_ {
+    ~cpputest_PublishScope_() { cpputest_publishing_ = false; }
+    std::uint_fast8_t qsId() const { return 0U; }
+};
+
+inline QEvt const* cpputest_onPublish_(QEvt const* e, void const* sender)
+{
+    ++cpputest_publishCount_;
+    cpputest_publishing_ = true;
+#ifdef CMS_ENABLE_QF_STATS
+    cpputest_statsOnPublish_();
+#endif
+    if (cpputest_trafficTapCount_ != 0U) {
+        cpputest_tapPublish_(e, sender);
+    }
+    return e;
+}
+
+inline QEvt const* cpputest_onPost_(QEvt const* e, void const* sender)
+{
+#ifdef CMS_ENABLE_QF_STATS
+    cpputest_statsOnPost_();
+#endif
+    if (cpputest_trafficTapCount_ != 0U) {
+        cpputest_tapPost_(e, sender);
+    }
+    return e;
+}
+
 } // namespace QP
 
+// as QF's own definitions without Q_SPY, which this port does not support,
+// except that publish_() is given the sender, for QF to pass on to the
+// POST() to each subscriber.
+#undef PUBLISH
+#define PUBLISH(e_, sender_) \
+publish_(QP::cpputest_onPublish_((e_), (sender_)), (sender_), \
+         QP::cpputest_PublishScope_().qsId())
+#undef POST
+#define POST(e_, sender_) \
+post_(QP::cpputest_onPost_((e_), (sender_)), QP::QF::NO_MARGIN, nullptr)
+#undef POST_X
+#define POST_X(e_, margin_, sender_) \
+post_(QP::cpputest_onPost_((e_), (sender_)), (margin_), nullptr)
+
 //============================================================================
 // interface used only inside QF implementation, but not in applications
 
 #ifdef QP_IMPL
 
-    // QF scheduler locking for POSIX-QV (not needed in single-thread port)
-    #define QF_SCHED_STAT_
-    #define QF_SCHED_LOCK_(dummy) (static_cast<void>(0))
-    #define QF_SCHED_UNLOCK_()    (static_cast<void>(0))
+    // QF scheduler locking, as the QK kernel, for SchedulingPolicy::QK
+    #define QF_SCHED_STAT_ std::uint_fast8_t lockStat_;
+    #define QF_SCHED_LOCK_(ceil_) ((lockStat_) = cpputest_schedLock_((ceil_)))
+    #define QF_SCHED_UNLOCK_()    (cpputest_schedUnlock_(lockStat_))
 
     #define QACTIVE_EQUEUE_WAIT_(me_) \
 Q_ASSERT_INCRIT(302, (me_)->m_eQueue.m_frontEvt != nullptr)
@@ -62,6 +235,7 @@ Q_ASSERT_INCRIT(302, (me_)->m_eQueue.m_frontEvt != nullptr)
 
 #define QACTIVE_EQUEUE_SIGNAL_(me_) do { \
     cpputest_readySet_.insert((me_)->m_prio); \
+    cpputest_preempt_(); \
 } while (false)
 
     // native QF event pool operations
@@ -70,12 +244,26 @@ Q_ASSERT_INCRIT(302, (me_)->m_eQueue.m_frontEvt != nullptr)
 (p_).init((poolSto_), (poolSize_), (evtSize_))
     #define QF_EPOOL_EVENT_SIZE_(p_)  ((p_).getBlockSize())
     #define QF_EPOOL_GET_(p_, e_, m_, qsId_) \
-((e_) = static_cast<QEvt *>((p_).get((m_), (qsId_))))
-    #define QF_EPOOL_PUT_(p_, e_, qsId_)  ((p_).put((e_), (qsId_)))
+((e_) = static_cast<QEvt *>(cpputest_poolGet_((p_), (m_), (qsId_))))
+    #define QF_EPOOL_PUT_(p_, e_, qsId_)  (cpputest_poolPut_((p_), (e_), (qsId_)))
 
 
 namespace QP {
 extern QPSet cpputest_readySet_; // ready set of active objects
+
+// SchedulingPolicy::QK: run any ready active objects above the running
+// one's preemption threshold and the scheduler lock ceiling.
+void cpputest_preempt_();
+
+// raise the scheduler lock ceiling, returning the previous ceiling to
+// restore with cpputest_schedUnlock_().
+std::uint_fast8_t cpputest_schedLock_(std::uint_fast8_t ceiling);
+void cpputest_schedUnlock_(std::uint_fast8_t previousCeiling);
+
+// event pool get and put, informing any PoolObserver
+void* cpputest_poolGet_(QMPool& pool, std::uint_fast16_t margin,
+                        std::uint_fast8_t qsId);
+void cpputest_poolPut_(QMPool& pool, void* block, std::uint_fast8_t qsId);
 } // namespace QP
 
 namespace QP {
@@ -0,0 +1,332 @@
+/// @brief Expectations matched against published events as they arrive.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cmsTestPublishedEventExpectations.hpp"
+#include "cms_cpputest_published_event_expectations_hooks.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include <array>
+#include <cassert>
+#include <cstdarg>
+#include <cstdio>
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+namespace cms {
+namespace test {
+
+namespace {
+
+// a fail fast failure found while QF dispatched to a recorder, raised by
+// OnProcessed() rather than unwinding QF's dispatch.
+std::array<char, 256> l_pendingFailure;
+bool l_failurePending = false;
+
+const char* KindName(size_t kind)
+{
+    static const char* const names[] = {"in order", "unordered",
+                                        "count within", "always"};
+    return (kind < (sizeof(names) / sizeof(names[0]))) ? names[kind] : "?";
+}
+
+unsigned CountBits(uint32_t bits)
+{
+    unsigned count = 0U;
+    for (; bits != 0U; bits &= bits - 1U) {
+        ++count;
+    }
+    return count;
+}
+
+long long Ms(std::chrono::milliseconds time)
+{
+    return static_cast<long long>(time.count());
+}
+
+}   // namespace
+
+bool PublishedEventExpectations::Step::Matches(QP::QEvt const* e) const
+{
+    return (e->sig == sig) && (!matches || matches(e));
+}
+
+PublishedEventExpectations::PublishedEventExpectations(bool failFast) :
+    m_expectations(), m_failure(), m_eventCount(0U), m_failFast(failFast),
+    m_failed(false)
+{
+}
+
+PublishedEventExpectations&
+PublishedEventExpectations::inOrder(std::initializer_list<Step> steps)
+{
+    assert(steps.size() != 0U);
+    m_expectations.push_back({Kind::IN_ORDER, steps,
+                              std::chrono::milliseconds(0), qf_ctrl::Now(),
+                              0U, 0U, 0U, 0U, 0U});
+    return *this;
+}
+
+PublishedEventExpectations&
+PublishedEventExpectations::unordered(std::initializer_list<Step> steps,
+                                      std::chrono::milliseconds window)
+{
+    assert((steps.size() != 0U) && (steps.size() <= MAX_UNORDERED_STEPS));
+    m_expectations.push_back({Kind::UNORDERED, steps, window, qf_ctrl::Now(),
+                              0U, 0U, 0U, 0U, 0U});
+    return *this;
+}
+
+PublishedEventExpectations&
+PublishedEventExpectations::countWithin(enum_t sig, uint32_t min, uint32_t max,
+                                        std::chrono::milliseconds period)
+{
+    assert(min <= max);
+    m_expectations.push_back({Kind::COUNT_WITHIN, {Step(sig)}, period,
+                              qf_ctrl::Now(), 0U, 0U, 0U, min, max});
+    return *this;
+}
+
+PublishedEventExpectations&
+PublishedEventExpectations::always(enum_t sig, Predicate predicate)
+{
+    m_expectations.push_back({Kind::ALWAYS, {Step(sig, std::move(predicate))},
+                              std::chrono::milliseconds(0), qf_ctrl::Now(),
+                              0U, 0U, 0U, 0U, 0U});
+    return *this;
+}
+
+void PublishedEventExpectations::onEvent(QP::QEvt const* e)
+{
+    // matching stops at the first failure
+    if (m_failed) {
+        return;
+    }
+
+    ++m_eventCount;
+    const auto now = qf_ctrl::Now();
+    for (size_t i = 0U; (i < m_expectations.size()) && !m_failed; ++i) {
+        Match(i, m_expectations[i], e, now);
+    }
+}
+
+void PublishedEventExpectations::Match(size_t index, Expectation& expectation,
+                                       QP::QEvt const* e,
+                                       std::chrono::milliseconds now)
+{
+    auto& steps     = expectation.steps;
+    const bool late = (now - expectation.start) > expectation.duration;
+    switch (expectation.kind) {
+        case Kind::IN_ORDER: {
+            if (expectation.next >= steps.size()) {
+                return;
+            }
+
+            bool inSequence = false;
+            for (auto const& step : steps) {
+                inSequence = inSequence || (step.sig == e->sig);
+            }
+            if (!inSequence) {
+                return;
+            }
+
+            Step const& step = steps[expectation.next];
+            if (step.sig != e->sig) {
+                Fail(index, e, "expected step %zu, sig %d",
+                     expectation.next + 1U, static_cast<int>(step.sig));
+            }
+            else if (!step.Matches(e)) {
+                Fail(index, e, "step %zu payload did not match",
+                     expectation.next + 1U);
+            }
+            else {
+                ++expectation.next;
+            }
+            break;
+        }
+        case Kind::UNORDERED: {
+            const uint32_t all =
+              (steps.size() == 32U) ? ~0U : ((1U << steps.size()) - 1U);
+            if (expectation.seen == all) {
+                return;
+            }
+            if ((expectation.seen != 0U) && late) {
+                Fail(index, e, "%u of %zu steps seen in the %lld ms window",
+                     CountBits(expectation.seen),
+                     steps.size(), Ms(expectation.duration));
+                return;
+            }
+
+            bool pending = false;
+            for (size_t i = 0U; i < steps.size(); ++i) {
+                const uint32_t bit = 1U << i;
+                if (((expectation.seen & bit) != 0U) ||
+                    (steps[i].sig != e->sig)) {
+                    continue;
+                }
+
+                pending = true;
+                if (steps[i].Matches(e)) {
+                    if (expectation.seen == 0U) {
+                        expectation.start = now;
+                    }
+                    expectation.seen |= bit;
+                    return;
+                }
+            }
+
+            if (pending) {
+                Fail(index, e, "payload did not match a step not yet seen");
+            }
+            break;
+        }
+        case Kind::COUNT_WITHIN:
+            if (late) {
+                if (expectation.count < expectation.min) {
+                    Fail(index, e, "sig %d seen %u times in %lld ms, "
+                         "expected at least %u",
+                         static_cast<int>(steps[0].sig),
+                         static_cast<unsigned>(expectation.count),
+                         Ms(expectation.duration),
+                         static_cast<unsigned>(expectation.min));
+                }
+                return;
+            }
+            if (e->sig == steps[0].sig) {
+                ++expectation.count;
+                if (expectation.count > expectation.max) {
+                    Fail(index, e, "sig %d seen more than %u times in %lld ms",
+                         static_cast<int>(steps[0].sig),
+                         static_cast<unsigned>(expectation.max),
+                         Ms(expectation.duration));
+                }
+            }
+            break;
+        case Kind::ALWAYS:
+            if ((e->sig == steps[0].sig) && !steps[0].Matches(e)) {
+                Fail(index, e, "payload did not match");
+            }
+            break;
+    }
+}
+
+void PublishedEventExpectations::verify()
+{
+    for (size_t i = 0U; (i < m_expectations.size()) && !m_failed; ++i) {
+        Expectation const& expectation = m_expectations[i];
+        switch (expectation.kind) {
+            case Kind::IN_ORDER:
+                if (expectation.next < expectation.steps.size()) {
+                    Fail(i, nullptr, "%zu of %zu steps seen", expectation.next,
+                         expectation.steps.size());
+                }
+                break;
+            case Kind::UNORDERED: {
+                const unsigned seen = CountBits(expectation.seen);
+                if (seen < expectation.steps.size()) {
+                    Fail(i, nullptr, "%u of %zu steps seen", seen,
+                         expectation.steps.size());
+                }
+                break;
+            }
+            case Kind::COUNT_WITHIN:
+                if (expectation.count < expectation.min) {
+                    Fail(i, nullptr, "sig %d seen %u times, expected at least %u",
+                         static_cast<int>(expectation.steps[0].sig),
+                         static_cast<unsigned>(expectation.count),
+                         static_cast<unsigned>(expectation.min));
+                }
+                break;
+            case Kind::ALWAYS:
+                break;
+        }
+    }
+
+    if (m_failed) {
+        FAIL(m_failure.data());
+    }
+}
+
+void PublishedEventExpectations::Fail(size_t index, QP::QEvt const* e,
+                                      const char* format, ...)
+{
+    m_failed = true;
+
+    int used;
+    const auto now = Ms(qf_ctrl::Now());
+    const auto kind =
+      KindName(static_cast<size_t>(m_expectations[index].kind));
+    if (e != nullptr) {
+        used = std::snprintf(m_failure.data(), m_failure.size(),
+                             "published event #%u (sig %d at %lld ms) failed "
+                             "expectation %zu (%s): ",
+                             static_cast<unsigned>(m_eventCount),
+                             static_cast<int>(e->sig), now, index + 1U, kind);
+    }
+    else {
+        used = std::snprintf(m_failure.data(), m_failure.size(),
+                             "at %lld ms, after %u published events, "
+                             "expectation %zu (%s) is incomplete: ",
+                             now, static_cast<unsigned>(m_eventCount),
+                             index + 1U, kind);
+    }
+
+    if ((used > 0) && (static_cast<size_t>(used) < m_failure.size())) {
+        va_list args;
+        va_start(args, format);
+        std::vsnprintf(&m_failure[static_cast<size_t>(used)],
+                       m_failure.size() - static_cast<size_t>(used), format,
+                       args);
+        va_end(args);
+    }
+
+    if (m_failFast && (e != nullptr)) {
+        if (QP::GetActivePriority() == 0U) {
+            FAIL(m_failure.data());
+        }
+        else {
+            std::snprintf(l_pendingFailure.data(), l_pendingFailure.size(),
+                          "%s", m_failure.data());
+            l_failurePending = true;
+        }
+    }
+}
+
+namespace expectations {
+
+void OnProcessed()
+{
+    if (l_failurePending) {
+        l_failurePending = false;
+        FAIL(l_pendingFailure.data());
+    }
+}
+
+void OnTeardown()
+{
+    l_failurePending = false;
+}
+
+}   // namespace expectations
+
+}   // namespace test
+}   // namespace cms
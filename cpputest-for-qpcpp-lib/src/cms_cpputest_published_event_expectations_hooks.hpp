@@ -0,0 +1,44 @@
+/// @brief qf_ctrl internal interface to the published event expectations.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_PUBLISHED_EVENT_EXPECTATIONS_HOOKS_HPP
+#define CMS_CPPUTEST_PUBLISHED_EVENT_EXPECTATIONS_HOOKS_HPP
+
+#include "cmsTestPublishedEventExpectations.hpp"
+
+namespace cms {
+namespace test {
+namespace expectations {
+
+// fail the running test with a failure found while QF dispatched, now
+// that the dispatch has returned.
+void OnProcessed();
+
+// forget a failure not yet raised.
+void OnTeardown();
+
+}   // namespace expectations
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_PUBLISHED_EVENT_EXPECTATIONS_HOOKS_HPP
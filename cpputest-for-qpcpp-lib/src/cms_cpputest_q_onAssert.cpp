@@ -2,7 +2,9 @@
 /// Q_onAssert(...).
 ///        This implementation uses cpputest mock and the TEST_EXIT macro
 ///        which throws an exception. This will generally not work in most
-///        of QP, as most methods are marked noexcept.
+///        of QP, as most methods are marked noexcept. For those, see
+///        cms::test::RunForQAssertDeath(), which runs the asserting code
+///        in a forked child process.
 ///
 /// @ingroup
 /// @cond
@@ -31,8 +33,95 @@
 #include "qsafe.h"
 #include "cmsQAssertMockSupport.hpp"
 #include "qassert-meta.h"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef CMS_QASSERT_DEATH_TEST_SUPPORTED
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 static bool m_printAssertMeta = true;
+static bool m_abortOnError    = false;
+
+namespace {
+
+/// Index of (module, id) -> qassert-meta description, filled on first
+/// lookup of each key. Assert heavy test suites hit the same few asserts
+/// many times, so later hits avoid searching the qassert-meta tables.
+/// Fixed size storage: this persists across tests and must not allocate,
+/// as the cpputest leak detector would flag it.
+constexpr std::size_t META_INDEX_SIZE = 256;   // must be a power of two
+constexpr std::size_t META_INDEX_MAX_USED = (META_INDEX_SIZE * 3U) / 4U;
+static_assert((META_INDEX_SIZE & (META_INDEX_SIZE - 1U)) == 0U,
+              "META_INDEX_SIZE must be a power of two");
+
+/// Longest module name indexed, with its terminator. Longer names are
+/// looked up without the index.
+constexpr std::size_t META_INDEX_MODULE_MAX = 64;
+
+/// The module name is copied, as a caller of QAssertMetaFind() may pass
+/// a temporary string; the index lives for the whole process.
+struct MetaIndexEntry {
+    char module[META_INDEX_MODULE_MAX];
+    int_t id;
+    bool found;
+    bool printed;
+    QAssertMetaDescription meta;
+};
+
+std::array<MetaIndexEntry, META_INDEX_SIZE> m_metaIndex {};
+std::size_t m_metaIndexUsed = 0;
+
+std::size_t MetaHash(const char* module, int_t id)
+{
+    // FNV-1a
+    std::uint32_t hash = 2166136261U;
+    for (const char* c = module; *c != '\0'; ++c) {
+        hash ^= static_cast<std::uint8_t>(*c);
+        hash *= 16777619U;
+    }
+    hash ^= static_cast<std::uint32_t>(id);
+    hash *= 16777619U;
+    return static_cast<std::size_t>(hash);
+}
+
+/// @return the index entry for (module, id), or nullptr when the index
+///         is full and the key is not already present.
+MetaIndexEntry* MetaIndexFind(const char* module, int_t id)
+{
+    const std::size_t length = std::strlen(module);
+    if ((length == 0U) || (length >= META_INDEX_MODULE_MAX)) {
+        return nullptr;
+    }
+
+    std::size_t slot = MetaHash(module, id) & (META_INDEX_SIZE - 1U);
+    for (std::size_t probes = 0; probes < META_INDEX_SIZE; ++probes) {
+        MetaIndexEntry& entry = m_metaIndex[slot];
+        if (entry.module[0] == '\0') {
+            if (m_metaIndexUsed >= META_INDEX_MAX_USED) {
+                return nullptr;
+            }
+            std::memcpy(entry.module, module, length + 1U);
+            entry.id     = id;
+            entry.found  = QAssertMetaGetDescription(module, id, &entry.meta);
+            ++m_metaIndexUsed;
+            return &entry;
+        }
+        if ((entry.id == id) && (std::strcmp(entry.module, module) == 0)) {
+            return &entry;
+        }
+        slot = (slot + 1U) & (META_INDEX_SIZE - 1U);
+    }
+    return nullptr;
+}
+
+}   // namespace
 
 void cms::test::QAssertMetaOutputEnable()
 {
@@ -44,19 +133,179 @@ void cms::test::QAssertMetaOutputDisable()
     m_printAssertMeta = false;
 }
 
+void cms::test::QAssertAbortEnable()
+{
+    m_abortOnError = true;
+}
+
+bool cms::test::QAssertMetaFind(const char* module, int id,
+                                QAssertMetaDescription* meta)
+{
+    MetaIndexEntry* entry = MetaIndexFind(module, id);
+    if (entry == nullptr) {
+        return QAssertMetaGetDescription(module, id, meta);
+    }
+
+    if (entry->found && (meta != nullptr)) {
+        *meta = entry->meta;
+    }
+    return entry->found;
+}
+
+void cms::test::QAssertMetaPrint(std::FILE* out, const char* module, int id)
+{
+    std::fprintf(out, "\n%s(%s:%d)\n", "Q_onError", module, id);
+
+    MetaIndexEntry* entry = MetaIndexFind(module, id);
+    QAssertMetaDescription uncached {};
+    bool found                         = false;
+    bool printDetails                  = true;
+    const QAssertMetaDescription* meta = &uncached;
+    if (entry != nullptr) {
+        found          = entry->found;
+        printDetails   = !entry->printed;
+        meta           = &entry->meta;
+        entry->printed = true;
+    }
+    else {
+        found = QAssertMetaGetDescription(module, id, &uncached);
+    }
+
+    if (!found) {
+        return;
+    }
+
+    if (printDetails) {
+        std::fprintf(out,
+                     "Additional details on (%s:%d):  %s\n"
+                     "Tips/More:\n%s\n"
+                     "URL:  %s\n",
+                     module, id, meta->brief, meta->tips, meta->url);
+    }
+    else {
+        std::fprintf(out, "Additional details on (%s:%d) printed above.\n",
+                     module, id);
+    }
+}
+
+#ifdef CMS_QASSERT_DEATH_TEST_SUPPORTED
+
+// write end of the pipe to the parent, valid only in a death test child.
+static int m_deathChildFd = -1;
+
+namespace {
+
+constexpr int DEATH_CHILD_ASSERTED  = 0;
+constexpr int DEATH_CHILD_NO_ASSERT = 1;
+constexpr int DEATH_CHILD_EXCEPTION = 2;
+
+[[noreturn]] void DeathChildReport(const char* module, int_t id)
+{
+    cms::test::QAssertDeathResult result {};
+    result.asserted = true;
+    std::strncpy(result.module, module, sizeof(result.module) - 1U);
+    result.id = id;
+
+    // best effort; the parent treats a short read as no assert.
+    ssize_t written = write(m_deathChildFd, &result, sizeof(result));
+    static_cast<void>(written);
+
+    // _exit: skip atexit handlers and stdio flushing, the parent
+    // still owns those.
+    _exit(DEATH_CHILD_ASSERTED);
+}
+
+}   // namespace
+
+cms::test::QAssertDeathResult
+cms::test::RunForQAssertDeath(QAssertDeathBody body, void* context)
+{
+    QAssertDeathResult result {};
+    result.asserted = false;
+    result.threw    = false;
+
+    int fds[2];
+    if (pipe(fds) != 0) {
+        FAIL("RunForQAssertDeath: pipe() failed");
+        return result;
+    }
+
+    const pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        FAIL("RunForQAssertDeath: fork() failed");
+        return result;
+    }
+
+    if (pid == 0) {
+        close(fds[0]);
+        m_deathChildFd = fds[1];
+
+        // nothing may unwind out of here: the child would go on running
+        // the rest of the suite, holding the pipe open.
+        try {
+            body(context);
+        }
+        catch (...) {
+            _exit(DEATH_CHILD_EXCEPTION);
+        }
+        _exit(DEATH_CHILD_NO_ASSERT);
+    }
+
+    close(fds[1]);
+    QAssertDeathResult received {};
+    std::size_t total = 0;
+    auto* bytes       = reinterpret_cast<char*>(&received);
+    while (total < sizeof(received)) {
+        ssize_t count = read(fds[0], bytes + total, sizeof(received) - total);
+        if (count > 0) {
+            total += static_cast<std::size_t>(count);
+        }
+        else if ((count < 0) && (errno == EINTR)) {
+            continue;
+        }
+        else {
+            break;
+        }
+    }
+    close(fds[0]);
+
+    int status = 0;
+    while ((waitpid(pid, &status, 0) < 0) && (errno == EINTR)) {
+    }
+
+    if ((total == sizeof(received)) && WIFEXITED(status) &&
+        (WEXITSTATUS(status) == DEATH_CHILD_ASSERTED)) {
+        result = received;
+        result.module[sizeof(result.module) - 1U] = '\0';
+    }
+    else if (WIFEXITED(status) &&
+             (WEXITSTATUS(status) == DEATH_CHILD_EXCEPTION)) {
+        result.threw = true;
+    }
+
+    return result;
+}
+
+#endif   // CMS_QASSERT_DEATH_TEST_SUPPORTED
+
 void Q_onError(char const* const module, int_t const id)
 {
+#ifdef CMS_QASSERT_DEATH_TEST_SUPPORTED
+    if (m_deathChildFd >= 0) {
+        DeathChildReport(module, id);
+    }
+#endif
+
     if (m_printAssertMeta)
     {
-        fprintf(stdout, "\n%s(%s:%d)\n", __FUNCTION__ , module, id);
-        QAssertMetaDescription meta;
-        bool found = QAssertMetaGetDescription(module, id, &meta);
-        if (found)
-        {
-            fprintf(stdout, "Additional details on (%s:%d):  %s\n", module, id, meta.brief);
-            fprintf(stdout, "Tips/More:\n%s\n", meta.tips);
-            fprintf(stdout, "URL:  %s\n", meta.url);
-        }
+        cms::test::QAssertMetaPrint(stdout, module, id);
+    }
+
+    if (m_abortOnError) {
+        std::fflush(stdout);
+        std::abort();
     }
 
     // The TEST_EXIT macro used below is throwing an exception.
@@ -0,0 +1,131 @@
+/// @brief Open addressing table of pool blocks, for qf_ctrl internal use.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_BLOCK_TABLE_HPP
+#define CMS_CPPUTEST_QF_BLOCK_TABLE_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace cms {
+namespace test {
+
+// Entries keyed on a pool block address, stored by open addressing with
+// linear probing. Removal shifts the following entries back, so no
+// tombstones build up and a table emptied by the test is empty for the
+// next one. 'Entry' has a 'void const* block' member, nullptr when free.
+// Filled to 3/4 at most, to keep probes short. Zero initialized as a
+// static, so holds no heap memory.
+template <class Entry, std::size_t Capacity>
+class BlockTable {
+public:
+    static_assert((Capacity & (Capacity - 1U)) == 0U,
+                  "BlockTable capacity must be a power of two");
+
+    static constexpr std::size_t MAX_COUNT = Capacity / 4U * 3U;
+
+    // \return the free entry now holding 'block', nullptr if full.
+    Entry* Insert(void const* block)
+    {
+        if (m_count >= MAX_COUNT) {
+            return nullptr;
+        }
+
+        std::size_t slot = HomeSlot(block);
+        while (m_entries[slot].block != nullptr) {
+            slot = (slot + 1U) & MASK;
+        }
+        m_entries[slot].block = block;
+        ++m_count;
+        return &m_entries[slot];
+    }
+
+    Entry* Find(void const* block)
+    {
+        std::size_t slot = HomeSlot(block);
+        while (m_entries[slot].block != nullptr) {
+            if (m_entries[slot].block == block) {
+                return &m_entries[slot];
+            }
+            slot = (slot + 1U) & MASK;
+        }
+        return nullptr;
+    }
+
+    // 'entry' was returned by Find() or Insert().
+    void Remove(Entry* entry)
+    {
+        auto hole = static_cast<std::size_t>(entry - m_entries.data());
+
+        // shift back each following entry whose home slot does not lie
+        // (cyclically) between the hole and itself
+        std::size_t slot = (hole + 1U) & MASK;
+        while (m_entries[slot].block != nullptr) {
+            const std::size_t home = HomeSlot(m_entries[slot].block);
+            if (((slot - home) & MASK) >= ((slot - hole) & MASK)) {
+                m_entries[hole] = m_entries[slot];
+                hole            = slot;
+            }
+            slot = (slot + 1U) & MASK;
+        }
+        m_entries[hole].block = nullptr;
+        --m_count;
+    }
+
+    void Clear()
+    {
+        if (m_count != 0U) {
+            for (auto& entry : m_entries) {
+                entry.block = nullptr;
+            }
+        }
+        m_count = 0;
+    }
+
+    std::size_t Count() const { return m_count; }
+
+    // every slot, free ones with a null 'block'
+    Entry const* begin() const { return m_entries.data(); }
+    Entry const* end() const { return m_entries.data() + Capacity; }
+
+private:
+    static constexpr std::size_t MASK = Capacity - 1U;
+
+    static std::size_t HomeSlot(void const* block)
+    {
+        // pool blocks are at least pointer aligned, drop the zero bits
+        const auto address = reinterpret_cast<std::uintptr_t>(block) >> 3U;
+        return static_cast<std::size_t>(
+                 address * UINT64_C(0x9E3779B97F4A7C15) >> 32U) &
+               MASK;
+    }
+
+    std::array<Entry, Capacity> m_entries;
+    std::size_t m_count;
+};
+
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_BLOCK_TABLE_HPP
@@ -0,0 +1,367 @@
+/// @brief Capture and replay of the external stimulus applied to
+///        active objects under test.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_capture.hpp"
+#include "cms_cpputest_qf_capture_hooks.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#define QP_IMPL   // need internal access from QP 8.1.0
+#include "qp_pkg.hpp"
+
+namespace cms {
+namespace test {
+namespace qf_ctrl {
+
+namespace {
+
+constexpr char CAPTURE_MAGIC[8] = {'C', 'M', 'S', 'Q', 'C', 'A', 'P', '1'};
+
+// TIME is a count of ticks, each followed by processing
+enum class RecordType : uint8_t { POST = 1, PUBLISH, PROCESS, TIME, CHECK };
+
+struct RecordHeader {
+    uint8_t type;
+    uint8_t prio;     // POST only
+    uint16_t sig;     // POST and PUBLISH only
+    uint32_t length;  // payload bytes following this header
+};
+static_assert(sizeof(RecordHeader) == 8, "unexpected record header padding");
+
+struct TraceCheck {
+    uint64_t hash;
+    uint32_t dispatches;
+    uint32_t reserved;
+};
+static_assert(sizeof(TraceCheck) == 16, "unexpected trace check padding");
+
+struct CaptureSession {
+    std::FILE* file;
+    bool ok;
+    std::vector<std::pair<enum_t, size_t>> eventSizes;
+};
+
+CaptureSession* l_capture = nullptr;
+
+// FNV-1a over the (priority, signal) of each dispatch since the last check
+constexpr uint64_t FNV_OFFSET = 14695981039346656037ULL;
+constexpr uint64_t FNV_PRIME  = 1099511628211ULL;
+uint64_t l_traceHash          = FNV_OFFSET;
+uint32_t l_traceDispatches    = 0;
+
+void TraceByte(uint8_t value)
+{
+    l_traceHash ^= value;
+    l_traceHash *= FNV_PRIME;
+}
+
+void OnTraceDispatch(void*, QP::QActive const* act, QP::QEvt const* e)
+{
+    TraceByte(act->getPrio());
+    TraceByte(static_cast<uint8_t>(e->sig & 0xFFU));
+    TraceByte(static_cast<uint8_t>(e->sig >> 8U));
+    ++l_traceDispatches;
+}
+
+const QP::DispatchObserver l_traceObserver = {&OnTraceDispatch, nullptr,
+                                              nullptr};
+
+void ResetTrace()
+{
+    l_traceHash       = FNV_OFFSET;
+    l_traceDispatches = 0;
+}
+
+void Write(const void* data, size_t size)
+{
+    if ((size != 0U) && (std::fwrite(data, size, 1, l_capture->file) != 1U)) {
+        l_capture->ok = false;
+    }
+}
+
+void WriteRecord(RecordType type, uint8_t prio, uint16_t sig,
+                 const void* payload, size_t length)
+{
+    RecordHeader header {static_cast<uint8_t>(type), prio, sig,
+                         static_cast<uint32_t>(length)};
+    Write(&header, sizeof(header));
+    Write(payload, length);
+}
+
+// log the dispatch trace caused by the prior stimulus, if any.
+void FlushTrace()
+{
+    if (l_traceDispatches == 0U) {
+        return;
+    }
+
+    TraceCheck check {l_traceHash, l_traceDispatches, 0U};
+    WriteRecord(RecordType::CHECK, 0U, 0U, &check, sizeof(check));
+    ResetTrace();
+}
+
+size_t CapturedEventSize(QP::QEvt const* e)
+{
+    if (e->poolNum_ != 0U) {
+        return QP::QF::priv_.ePool_[e->poolNum_ - 1U].getBlockSize();
+    }
+
+    for (const auto& entry : l_capture->eventSizes) {
+        if (entry.first == e->sig) {
+            return entry.second;
+        }
+    }
+
+    return sizeof(QP::QEvt);
+}
+
+void CaptureEvent(RecordType type, uint8_t prio, QP::QEvt const* e)
+{
+    FlushTrace();
+    WriteRecord(type, prio, e->sig, e, CapturedEventSize(e));
+}
+
+QP::QEvt const* NewReplayEvent(const RecordHeader& header,
+                               const std::vector<uint8_t>& payload)
+{
+    const size_t size = std::max(payload.size(), sizeof(QP::QEvt));
+    QP::QEvt* e = QP::QF::newX_(static_cast<uint_fast16_t>(size),
+                                QP::QF::NO_MARGIN, header.sig);
+
+    // the QEvt header (signal, pool, reference count) belongs to the
+    // new event, only the event's own fields are replayed.
+    if (payload.size() > sizeof(QP::QEvt)) {
+        std::memcpy(reinterpret_cast<uint8_t*>(e) + sizeof(QP::QEvt),
+                    payload.data() + sizeof(QP::QEvt),
+                    payload.size() - sizeof(QP::QEvt));
+    }
+    return e;
+}
+
+QP::QActive* ActiveObjectAt(uint8_t prio)
+{
+#if QP_VERSION > 800
+    return QP::QActive::fromRegistry(prio);
+#else
+    return QP::QActive::registry_[prio];
+#endif
+}
+
+}   // namespace
+
+bool StartCapture(const char* path)
+{
+    assert(l_capture == nullptr);
+
+    std::FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    l_capture       = new CaptureSession();
+    l_capture->file = file;
+    l_capture->ok   = true;
+    Write(CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+
+    ResetTrace();
+    bool added = QP::AddDispatchObserver(&l_traceObserver);
+    assert(added);
+    static_cast<void>(added);
+    return true;
+}
+
+void RegisterCaptureEventSize(enum_t sig, size_t eventSize)
+{
+    assert(l_capture != nullptr);
+    assert(eventSize >= sizeof(QP::QEvt));
+    l_capture->eventSizes.emplace_back(sig, eventSize);
+}
+
+bool StopCapture()
+{
+    assert(l_capture != nullptr);
+
+    FlushTrace();
+    QP::RemoveDispatchObserver(&l_traceObserver);
+
+    bool ok = l_capture->ok && (std::fclose(l_capture->file) == 0);
+    delete l_capture;
+    l_capture = nullptr;
+    return ok;
+}
+
+bool IsCapturing()
+{
+    return l_capture != nullptr;
+}
+
+void CaptureOnPost(QP::QEvt const* e, QP::QActive const* dest)
+{
+    if (l_capture != nullptr) {
+        CaptureEvent(RecordType::POST, dest->getPrio(), e);
+    }
+}
+
+void CaptureOnPublish(QP::QEvt const* e)
+{
+    if (l_capture != nullptr) {
+        CaptureEvent(RecordType::PUBLISH, 0U, e);
+    }
+}
+
+void CaptureOnProcess()
+{
+    if (l_capture != nullptr) {
+        FlushTrace();
+        WriteRecord(RecordType::PROCESS, 0U, 0U, nullptr, 0U);
+    }
+}
+
+void CaptureOnTicks(uint64_t ticks)
+{
+    if (l_capture != nullptr) {
+        FlushTrace();
+        WriteRecord(RecordType::TIME, 0U, 0U, &ticks, sizeof(ticks));
+    }
+}
+
+ReplayResult Replay(const char* path)
+{
+    assert(l_capture == nullptr);
+
+    ReplayResult result {};
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        return result;
+    }
+
+    char magic[sizeof(CAPTURE_MAGIC)] = {};
+    if ((std::fread(magic, sizeof(magic), 1, file) != 1U) ||
+        (std::memcmp(magic, CAPTURE_MAGIC, sizeof(magic)) != 0)) {
+        std::fclose(file);
+        return result;
+    }
+
+    result.loaded  = true;
+    result.matched = true;
+
+    ResetTrace();
+    bool added = QP::AddDispatchObserver(&l_traceObserver);
+    assert(added);
+    static_cast<void>(added);
+
+    auto mismatch = [&result]() {
+        result.matched        = false;
+        result.mismatchRecord = result.records;
+    };
+
+    RecordHeader header {};
+    std::vector<uint8_t> payload;
+    while (result.matched &&
+           (std::fread(&header, sizeof(header), 1, file) == 1U)) {
+        payload.resize(header.length);
+        if ((header.length != 0U) &&
+            (std::fread(payload.data(), header.length, 1, file) != 1U)) {
+            result.loaded = false;
+            break;
+        }
+        ++result.records;
+
+        const auto type = static_cast<RecordType>(header.type);
+        if ((type != RecordType::CHECK) && (l_traceDispatches != 0U)) {
+            // dispatches happened where the capture saw none
+            mismatch();
+            break;
+        }
+
+        switch (type) {
+            case RecordType::POST: {
+                // the file may come from a different set of active objects
+                QP::QActive* dest = (header.prio <= QF_MAX_ACTIVE)
+                                      ? ActiveObjectAt(header.prio)
+                                      : nullptr;
+                if (dest == nullptr) {
+                    result.loaded = false;
+                    break;
+                }
+                dest->POST(NewReplayEvent(header, payload), nullptr);
+            } break;
+            case RecordType::PUBLISH:
+                QP::QF::PUBLISH(NewReplayEvent(header, payload), nullptr);
+                break;
+            case RecordType::PROCESS:
+                ProcessEvents();
+                break;
+            case RecordType::TIME: {
+                uint64_t ticks = 0;
+                if (payload.size() != sizeof(ticks)) {
+                    result.loaded = false;
+                    break;
+                }
+                std::memcpy(&ticks, payload.data(), sizeof(ticks));
+                AdvanceTicks(ticks);
+            } break;
+            case RecordType::CHECK: {
+                TraceCheck check {};
+                if (payload.size() != sizeof(check)) {
+                    result.loaded = false;
+                    break;
+                }
+                std::memcpy(&check, payload.data(), sizeof(check));
+                ++result.checks;
+                if ((check.hash != l_traceHash) ||
+                    (check.dispatches != l_traceDispatches)) {
+                    mismatch();
+                }
+                ResetTrace();
+            } break;
+            default:
+                result.loaded = false;
+                break;
+        }
+
+        if (!result.loaded) {
+            break;
+        }
+    }
+
+    if (result.matched && (l_traceDispatches != 0U)) {
+        mismatch();
+    }
+
+    QP::RemoveDispatchObserver(&l_traceObserver);
+    std::fclose(file);
+    return result;
+}
+
+}   // namespace qf_ctrl
+}   // namespace test
+}   // namespace cms
@@ -0,0 +1,48 @@
+/// @brief Hooks between the qf_ctrl module and stimulus capture.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_CAPTURE_HOOKS_HPP
+#define CMS_CPPUTEST_QF_CAPTURE_HOOKS_HPP
+
+#include <cstdint>
+#include "qpcpp.hpp"
+
+namespace cms {
+namespace test {
+namespace qf_ctrl {
+
+// each is a no-op unless a capture is in progress
+void CaptureOnPost(QP::QEvt const* e, QP::QActive const* dest);
+void CaptureOnPublish(QP::QEvt const* e);
+void CaptureOnProcess();
+void CaptureOnTicks(uint64_t ticks);
+
+// run 'ticks' clock ticks, each followed by processing, and any
+// timeline stimuli falling due.
+void AdvanceTicks(uint64_t ticks);
+
+}   // namespace qf_ctrl
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_CAPTURE_HOOKS_HPP
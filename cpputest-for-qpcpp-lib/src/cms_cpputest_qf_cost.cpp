@@ -0,0 +1,320 @@
+/// @brief Simulated CPU cost model and response time report.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_cost.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+
+namespace cms {
+namespace test {
+namespace cost {
+
+namespace {
+
+using HostClock = std::chrono::steady_clock;
+
+struct DeclaredCost {
+    QP::QActive const* ao;
+    enum_t sig;
+    Microseconds cost;
+};
+
+// per active object settings, kept across Enable()
+struct ActiveObjectSettings {
+    QP::QActive const* ao;
+    const char* name;
+    Microseconds deadline;
+};
+
+struct ActiveObjectRecord {
+    QP::QActive const* ao;
+    ActiveObjectStats stats;
+};
+
+// a dispatch in progress; QK preemption nests them
+struct Dispatch {
+    Microseconds release;   // qf_ctrl::Now() when dispatched
+    Microseconds start;
+    HostClock::time_point hostStart;
+    HostClock::duration nestedHost;   // host time of preempting dispatches
+};
+
+constexpr size_t MAX_ACTIVE_OBJECTS = QF_MAX_ACTIVE + 1U;
+
+std::array<DeclaredCost, CMS_COST_MAX_DECLARED> l_declared;
+size_t l_declaredCount = 0;
+
+std::array<ActiveObjectSettings, MAX_ACTIVE_OBJECTS> l_settings;
+size_t l_settingsCount = 0;
+
+std::array<ActiveObjectRecord, MAX_ACTIVE_OBJECTS> l_records;   // by priority
+std::array<Dispatch, MAX_ACTIVE_OBJECTS> l_dispatches;
+size_t l_depth = 0;
+
+double l_measuredScale = 0.0;
+bool l_enabled         = false;
+Microseconds l_cpuFree(0);   // when the simulated CPU finishes its work
+Microseconds l_busy(0);
+
+Microseconds WallTime()
+{
+    return std::chrono::duration_cast<Microseconds>(qf_ctrl::Now());
+}
+
+ActiveObjectSettings* FindSettings(QP::QActive const* ao, bool create)
+{
+    for (size_t i = 0; i < l_settingsCount; ++i) {
+        if (l_settings[i].ao == ao) {
+            return &l_settings[i];
+        }
+    }
+    if (!create || (l_settingsCount == l_settings.size())) {
+        return nullptr;
+    }
+    l_settings[l_settingsCount] = ActiveObjectSettings {ao, nullptr, Microseconds(0)};
+    return &l_settings[l_settingsCount++];
+}
+
+bool FindDeclaredCost(QP::QActive const* ao, enum_t sig, Microseconds* cost)
+{
+    bool found = false;
+    for (size_t i = 0; i < l_declaredCount; ++i) {
+        const DeclaredCost& declared = l_declared[i];
+        if (declared.sig != sig) {
+            continue;
+        }
+        if (declared.ao == ao) {
+            *cost = declared.cost;
+            return true;
+        }
+        if (declared.ao == nullptr) {
+            *cost = declared.cost;
+            found = true;
+        }
+    }
+    return found;
+}
+
+void OnBeforeDispatch(void*, QP::QActive const*, QP::QEvt const*)
+{
+    assert(l_depth < l_dispatches.size());
+    const Microseconds wall = WallTime();
+    l_dispatches[l_depth]   = Dispatch {wall, std::max(l_cpuFree, wall),
+                                      HostClock::now(),
+                                      HostClock::duration::zero()};
+    ++l_depth;
+}
+
+void OnAfterDispatch(void*, QP::QActive const* act, QP::QEvt const* e)
+{
+    assert(l_depth > 0U);
+    --l_depth;
+    const Dispatch& dispatch = l_dispatches[l_depth];
+
+    const HostClock::duration host =
+      HostClock::now() - dispatch.hostStart - dispatch.nestedHost;
+    if (l_depth > 0U) {
+        l_dispatches[l_depth - 1U].nestedHost += host + dispatch.nestedHost;
+    }
+
+    Microseconds cost(0);
+    if (!FindDeclaredCost(act, e->sig, &cost)) {
+        cost = std::chrono::duration_cast<Microseconds>(
+          std::chrono::duration<double, std::micro>(host) * l_measuredScale);
+    }
+
+    // a preempting dispatch has already moved l_cpuFree past 'start'
+    const Microseconds end = std::max(l_cpuFree, dispatch.start) + cost;
+    l_cpuFree              = end;
+    l_busy += cost;
+
+    const Microseconds response = end - dispatch.release;
+
+    ActiveObjectRecord& record = l_records[act->getPrio()];
+    record.ao                  = act;
+    ActiveObjectStats& stats   = record.stats;
+    ++stats.dispatches;
+    stats.busy += cost;
+    if ((stats.dispatches == 1U) || (response > stats.worstResponse)) {
+        stats.worstResponse    = response;
+        stats.worstResponseSig = e->sig;
+    }
+
+    const ActiveObjectSettings* settings = FindSettings(act, false);
+    if (settings != nullptr) {
+        stats.deadline = settings->deadline;
+        if ((settings->deadline.count() > 0) && (response > settings->deadline)) {
+            ++stats.deadlineMisses;
+        }
+    }
+}
+
+const QP::DispatchObserver l_costObserver = {&OnBeforeDispatch,
+                                             &OnAfterDispatch, nullptr};
+
+}   // namespace
+
+void Enable()
+{
+    if (!l_enabled) {
+        const bool added = QP::AddDispatchObserver(&l_costObserver);
+        assert(added);
+        static_cast<void>(added);
+        l_enabled = true;
+    }
+
+    l_records.fill(ActiveObjectRecord {});
+    l_depth   = 0;
+    l_cpuFree = Microseconds(0);
+    l_busy    = Microseconds(0);
+}
+
+void Disable()
+{
+    if (l_enabled) {
+        QP::RemoveDispatchObserver(&l_costObserver);
+        l_enabled = false;
+    }
+}
+
+bool IsEnabled()
+{
+    return l_enabled;
+}
+
+bool DeclareCost(QP::QActive const* ao, enum_t sig, Microseconds cost)
+{
+    assert(cost.count() >= 0);
+
+    for (size_t i = 0; i < l_declaredCount; ++i) {
+        if ((l_declared[i].ao == ao) && (l_declared[i].sig == sig)) {
+            l_declared[i].cost = cost;
+            return true;
+        }
+    }
+
+    if (l_declaredCount == l_declared.size()) {
+        return false;
+    }
+    l_declared[l_declaredCount++] = DeclaredCost {ao, sig, cost};
+    return true;
+}
+
+void SetMeasuredScale(double scale)
+{
+    assert(scale >= 0.0);
+    l_measuredScale = scale;
+}
+
+void SetDeadline(QP::QActive const* ao, Microseconds deadline)
+{
+    assert(ao != nullptr);
+    ActiveObjectSettings* settings = FindSettings(ao, true);
+    assert(settings != nullptr);
+    settings->deadline = deadline;
+}
+
+void NameActiveObject(QP::QActive const* ao, const char* name)
+{
+    assert(ao != nullptr);
+    ActiveObjectSettings* settings = FindSettings(ao, true);
+    assert(settings != nullptr);
+    settings->name = name;
+}
+
+void Clear()
+{
+    l_declaredCount = 0;
+    l_settingsCount = 0;
+    l_measuredScale = 0.0;
+}
+
+bool GetStats(QP::QActive const* ao, ActiveObjectStats* stats)
+{
+    assert(ao != nullptr);
+    assert(stats != nullptr);
+
+    const ActiveObjectRecord& record = l_records[ao->getPrio()];
+    if (record.ao != ao) {
+        return false;
+    }
+    *stats = record.stats;
+    return true;
+}
+
+Microseconds Busy()
+{
+    return l_busy;
+}
+
+Microseconds Backlog()
+{
+    const Microseconds wall = WallTime();
+    return (l_cpuFree > wall) ? (l_cpuFree - wall) : Microseconds(0);
+}
+
+void Report(std::FILE* out)
+{
+    assert(out != nullptr);
+
+    std::fprintf(out, "%-24s %4s %10s %12s %14s %8s %12s %6s\n",
+                 "active object", "prio", "dispatches", "busy (us)",
+                 "worst (us)", "signal", "deadline (us)", "misses");
+    for (size_t prio = 0; prio < l_records.size(); ++prio) {
+        const ActiveObjectRecord& record = l_records[prio];
+        if (record.ao == nullptr) {
+            continue;
+        }
+
+        const ActiveObjectSettings* settings = FindSettings(record.ao, false);
+        const char* name = ((settings != nullptr) && (settings->name != nullptr))
+                             ? settings->name
+                             : "-";
+        const ActiveObjectStats& stats = record.stats;
+        std::fprintf(out, "%-24s %4zu %10u %12lld %14lld %8d %12lld %6u\n",
+                     name, prio, stats.dispatches,
+                     static_cast<long long>(stats.busy.count()),
+                     static_cast<long long>(stats.worstResponse.count()),
+                     static_cast<int>(stats.worstResponseSig),
+                     static_cast<long long>(stats.deadline.count()),
+                     stats.deadlineMisses);
+    }
+
+    const Microseconds elapsed = std::max(WallTime(), l_cpuFree);
+    const double load          = (elapsed.count() > 0)
+                                   ? 100.0 * static_cast<double>(l_busy.count()) /
+                                       static_cast<double>(elapsed.count())
+                                   : 0.0;
+    std::fprintf(out, "CPU busy %lld us of %lld us (%.1f%%), backlog %lld us\n",
+                 static_cast<long long>(l_busy.count()),
+                 static_cast<long long>(elapsed.count()), load,
+                 static_cast<long long>(Backlog().count()));
+}
+
+}   // namespace cost
+}   // namespace test
+}   // namespace cms
@@ -23,16 +23,37 @@
 /// @endcond
 
 #include "cms_cpputest_qf_ctrl.hpp"
+#include "cms_cpputest_published_event_expectations_hooks.hpp"
+#include "cms_cpputest_qf_capture.hpp"
+#include "cms_cpputest_qf_capture_hooks.hpp"
+#include "cms_cpputest_qf_cost.hpp"
+#include "cms_cpputest_qf_leaks_hooks.hpp"
+#include "cms_cpputest_qf_lifetime_hooks.hpp"
+#include "cms_cpputest_qf_metrics_hooks.hpp"
+#include "cms_cpputest_qf_pool_overflow_hooks.hpp"
+#include "cms_cpputest_qf_pool_storage.hpp"
+#include "cms_cpputest_qf_ram_hooks.hpp"
+#include "cms_cpputest_qf_stats.hpp"
+#include "cms_cpputest_timing_wheel_hooks.hpp"
 #include "cmsTestPublishedEventRecorder.hpp"
 #include "qpcpp.hpp"
 #include <algorithm>
+#include <array>
 #include <cassert>
+#include <cstdlib>
+#include <cstring>
 #include <vector>
 #include "CppUTest/TestHarness.h"
 
 #define QP_IMPL   // need internal access from QP 8.1.0
 #include "qp_pkg.hpp"
 
+namespace QP {
+// the port's ready set (qp_port.hpp declares it for QP_IMPL only, which
+// was not yet defined when qpcpp.hpp was included above)
+extern QPSet cpputest_readySet_;
+}   // namespace QP
+
 namespace cms {
 namespace test {
 namespace qf_ctrl {
@@ -44,20 +65,74 @@ using SubscriberList                       = std::vector<QP::QSubscrList>;
 static SubscriberList* l_subscriberStorage = nullptr;
 
 static uint32_t l_ticksPerSecond = 0;
+static uint64_t l_tickCount      = 0;
+static uint64_t l_heldTicks      = 0;   // ticks waiting for the simulated CPU
+
+struct TimelineEntry {
+    uint64_t dueTick;
+    uint64_t sequence;   // orders entries due on the same tick
+    uint64_t periodTicks;
+    QP::QActive* dest;   // nullptr to publish
+    QP::QEvt const* event;   // nullptr to allocate a QEvt with 'sig'
+    enum_t sig;
+};
+
+// min-heap on (dueTick, sequence)
+struct TimelineLater {
+    bool operator()(const TimelineEntry& a, const TimelineEntry& b) const
+    {
+        return (a.dueTick != b.dueTick) ? (a.dueTick > b.dueTick)
+                                        : (a.sequence > b.sequence);
+    }
+};
+
+using Timeline = std::vector<TimelineEntry>;
+static Timeline* l_timeline        = nullptr;
+static uint64_t l_timelineSequence = 0;
 
 static MemPoolTeardownOption l_memPoolOption = MemPoolTeardownOption::CHECK_FOR_LEAKS;
 
+// pool storage comes from pool_storage, released as a whole by Teardown()
 struct InternalPoolConfig {
     explicit InternalPoolConfig(const MemPoolConfig& conf) :
-        config(conf), storage()
+        config(conf),
+        storageSize(config.eventSize * config.numberOfEvents),
+        storage(pool_storage::Acquire(storageSize))
     {
-        storage.resize(config.eventSize * config.numberOfEvents);
     }
     MemPoolConfig config;
-    std::vector<uint8_t> storage;
+    size_t storageSize;
+    uint8_t* storage;
 };
 static std::vector<InternalPoolConfig>* l_pubSubEventMemPoolConfigs = nullptr;
 
+// Checkpoint storage must outlive the test which captured it, so it is
+// allocated with malloc, out of sight of the cpputest leak detector.
+struct CheckpointState {
+    char* group;   // the TEST_GROUP which captured the checkpoint
+    MemoryRegion* userRegions;
+    size_t userRegionCount;
+    size_t subscriberCount;
+    size_t poolCount;
+    unsigned char* bytes;
+    size_t byteCount;
+    uint64_t tickCount;   // the virtual clock, see Now()
+    uint64_t heldTicks;
+    uint64_t timelineSequence;
+    TimelineEntry* timeline;
+    size_t timelineCount;
+};
+static CheckpointState l_checkpoint = {};
+
+static size_t PoolFreeCount(size_t poolIndex)
+{
+#if QP_VERSION < 810
+    return QP::QF::priv_.ePool_[poolIndex].getNFree();
+#else
+    return QP::QF::priv_.ePool_[poolIndex].getFree();
+#endif
+}
+
 void Setup(enum_t const maxPubSubSignalValue, uint32_t ticksPerSecond,
            const MemPoolConfigs& pubSubEventMemPoolConfigs,
            MemPoolTeardownOption memPoolOpt)
@@ -70,6 +145,13 @@ void Setup(enum_t const maxPubSubSignalValue, uint32_t ticksPerSecond,
 
     l_memPoolOption     = memPoolOpt;
     l_ticksPerSecond    = ticksPerSecond;
+    l_tickCount         = 0;
+    l_heldTicks         = 0;
+    l_timeline          = new Timeline();
+    l_timelineSequence  = 0;
+    TimingWheelReset();
+    leaks::OnSetup();
+    lifetime::OnSetup();
     l_subscriberStorage = new SubscriberList();
     l_subscriberStorage->resize(static_cast<size_t>(maxPubSubSignalValue));
     QSubscrList nullValue = QSubscrList();
@@ -87,18 +169,39 @@ void Setup(enum_t const maxPubSubSignalValue, uint32_t ticksPerSecond,
     QF::psInit(l_subscriberStorage->data(), maxPubSubSignalValue);
 
     for (auto& config : *l_pubSubEventMemPoolConfigs) {
-        QF::poolInit(config.storage.data(), config.storage.size(),
+        QF::poolInit(config.storage, config.storageSize,
                      config.config.eventSize);
     }
+
+    ResetStats();
+    metrics::OnSetup();
 }
 
 void Teardown()
 {
     using namespace QP;
 
+    ram::OnTeardown();
+    metrics::OnTeardown();
+
+    // a capture left open by a failed test must not outlive it
+    if (IsCapturing()) {
+        StopCapture();
+    }
+
+    cost::Disable();
+    expectations::OnTeardown();
+
     delete l_subscriberStorage;
     l_subscriberStorage = nullptr;
 
+    // stimuli never applied must not be reported as pool leaks
+    if (l_timeline != nullptr) {
+        ClearTimeline();
+        delete l_timeline;
+        l_timeline = nullptr;
+    }
+
     l_ticksPerSecond = 0;
 
     QF::stop();
@@ -114,21 +217,32 @@ void Teardown()
                 const size_t poolNumOfEvents =
                   l_pubSubEventMemPoolConfigs->at(i).config.numberOfEvents;
 
-#if QP_VERSION < 810
-                const auto freeEvents = QP::QF::priv_.ePool_[i].getNFree();
-#else
-                const auto freeEvents = QP::QF::priv_.ePool_[i].getFree();
-#endif
+                const auto freeEvents = PoolFreeCount(i);
 
                 if (poolNumOfEvents != freeEvents) {
                     leakDetected = true;
                     fprintf(stderr, "Memory leak in pool: %zu\n", i);
                 }
             }
+
+            const size_t overflowEvents = overflow::LiveBlocks();
+            if (overflowEvents != 0U) {
+                leakDetected = true;
+                fprintf(stderr, "Memory leak in pool overflow: %zu events\n",
+                        overflowEvents);
+            }
+        }
+
+        if (leakDetected && leaks::IsEnabled()) {
+            leaks::Report(stderr);
         }
 
+        // after the leak report, which reads the overflow events
+        overflow::OnTeardown();
+
         delete l_pubSubEventMemPoolConfigs;
         l_pubSubEventMemPoolConfigs = nullptr;
+        pool_storage::Release();
 
         CHECK_TRUE_TEXT(!leakDetected, "A leak was detected in an internal QF event pool!");
     }
@@ -139,9 +253,26 @@ void ChangeMemPoolTeardownOption(MemPoolTeardownOption memPoolOpt)
     l_memPoolOption = memPoolOpt;
 }
 
-void ProcessEvents()
+// with the cost model enabled, ticks and dispatch wait for the CPU
+static bool IsCpuBusy()
+{
+    return cost::IsEnabled() && (cost::Backlog().count() > 0);
+}
+
+// run the ready active objects, then raise any test failure which was
+// held back until QF's dispatch returned.
+static void RunReadyActiveObjects()
 {
     QP::RunUntilNoReadyActiveObjects();
+    expectations::OnProcessed();
+}
+
+void ProcessEvents()
+{
+    CaptureOnProcess();
+    if (!IsCpuBusy()) {
+        RunReadyActiveObjects();
+    }
 }
 
 void MoveTimeForward(const std::chrono::milliseconds& duration)
@@ -159,23 +290,195 @@ void MoveTimeForward(const std::chrono::milliseconds& duration)
     LoopCounter_t ticks = std::max(
       ONCE, static_cast<LoopCounter_t>(duration.count() / millisecondsPerTick));
 
-    for (LoopCounter_t i = 0; i < ticks; ++i) {
-        QP::QTimeEvt::tick(0, nullptr);
-        ProcessEvents();
+    AdvanceTicks(ticks);
+}
+
+static bool IsStimulusDue()
+{
+    return (l_timeline != nullptr) && !l_timeline->empty() &&
+           (l_timeline->front().dueTick <= l_tickCount);
+}
+
+static void ApplyDueStimuli()
+{
+    while (IsStimulusDue()) {
+        std::pop_heap(l_timeline->begin(), l_timeline->end(), TimelineLater());
+        TimelineEntry entry = l_timeline->back();
+        l_timeline->pop_back();
+
+        QP::QEvt const* e = entry.event;
+        if (e == nullptr) {
+            e = Q_NEW(QP::QEvt, entry.sig);
+        }
+
+        if (entry.dest != nullptr) {
+            CaptureOnPost(e, entry.dest);
+            entry.dest->POST(e, nullptr);
+        }
+        else {
+            PublishEvent(e);
+        }
+
+        if (entry.periodTicks != 0U) {
+            entry.dueTick += entry.periodTicks;
+            entry.sequence = l_timelineSequence++;
+            l_timeline->push_back(entry);
+            std::push_heap(l_timeline->begin(), l_timeline->end(),
+                           TimelineLater());
+        }
+    }
+
+    ProcessEvents();
+}
+
+void AdvanceTicks(uint64_t ticks)
+{
+    while (ticks > 0U) {
+        // run ticks in segments ending at the next due stimulus, so
+        // a capture logs them in the order they are applied.
+        uint64_t segment = ticks;
+        if ((l_timeline != nullptr) && !l_timeline->empty()) {
+            const uint64_t due = l_timeline->front().dueTick;
+            segment = (due > l_tickCount) ? std::min(ticks, due - l_tickCount)
+                                          : 1U;
+        }
+
+        CaptureOnTicks(segment);
+        for (uint64_t i = 0; i < segment; ++i) {
+            ++l_heldTicks;
+            ++l_tickCount;
+            CMS_QF_STATS_TICK();
+            if (IsCpuBusy()) {
+                continue;
+            }
+
+            // run any ticks held while the CPU was busy, late
+            for (; l_heldTicks > 0U; --l_heldTicks) {
+                QP::QTimeEvt::tick(0, nullptr);
+                TimingWheelTick();
+            }
+            RunReadyActiveObjects();
+        }
+        ticks -= segment;
+
+        if (IsStimulusDue()) {
+            ApplyDueStimuli();
+        }
     }
 }
 
+std::chrono::milliseconds Now()
+{
+    assert(l_ticksPerSecond != 0);
+    return std::chrono::milliseconds(l_tickCount * 1000U / l_ticksPerSecond);
+}
+
+uint64_t TicksSinceSetup()
+{
+    return l_tickCount;
+}
+
+static uint64_t MillisecondsToTicks(const std::chrono::milliseconds& time)
+{
+    assert(l_ticksPerSecond != 0);
+    assert(time.count() >= 0);
+
+    // round up: a stimulus is never applied early
+    const auto milliseconds = static_cast<uint64_t>(time.count());
+    return (milliseconds * l_ticksPerSecond + 999U) / 1000U;
+}
+
+static void Schedule(uint64_t dueTick, uint64_t periodTicks,
+                     QP::QActive* dest, QP::QEvt const* e, enum_t sig)
+{
+    assert(l_timeline != nullptr);
+
+    // a pool event can be delivered only once
+    assert((periodTicks == 0U) || (e == nullptr) || (e->poolNum_ == 0U));
+
+    l_timeline->push_back(TimelineEntry {dueTick, l_timelineSequence++,
+                                         periodTicks, dest, e, sig});
+    std::push_heap(l_timeline->begin(), l_timeline->end(), TimelineLater());
+}
+
+void ScheduledStimulus::Post(QP::QActive* dest, QP::QEvt const* e)
+{
+    assert(dest != nullptr);
+    assert(e != nullptr);
+    Schedule(m_dueTick, m_periodTicks, dest, e, e->sig);
+}
+
+void ScheduledStimulus::Post(QP::QActive* dest, enum_t sig)
+{
+    assert(dest != nullptr);
+    Schedule(m_dueTick, m_periodTicks, dest, nullptr, sig);
+}
+
+void ScheduledStimulus::Publish(QP::QEvt const* e)
+{
+    assert(e != nullptr);
+    Schedule(m_dueTick, m_periodTicks, nullptr, e, e->sig);
+}
+
+void ScheduledStimulus::Publish(enum_t sig)
+{
+    Schedule(m_dueTick, m_periodTicks, nullptr, nullptr, sig);
+}
+
+ScheduledStimulus At(const std::chrono::milliseconds& time)
+{
+    return ScheduledStimulus(MillisecondsToTicks(time), 0U);
+}
+
+ScheduledStimulus After(const std::chrono::milliseconds& delay)
+{
+    return At(Now() + delay);
+}
+
+ScheduledStimulus Every(const std::chrono::milliseconds& period)
+{
+    const uint64_t periodTicks = std::max<uint64_t>(1U, MillisecondsToTicks(period));
+    return ScheduledStimulus(l_tickCount + periodTicks, periodTicks);
+}
+
+size_t PendingStimuli()
+{
+    return (l_timeline != nullptr) ? l_timeline->size() : 0U;
+}
+
+void ClearTimeline()
+{
+    if (l_timeline == nullptr) {
+        return;
+    }
+
+    for (const auto& entry : *l_timeline) {
+        if ((entry.event != nullptr) && (entry.event->poolNum_ != 0U)) {
+            QP::QF::gc(entry.event);
+        }
+    }
+    l_timeline->clear();
+}
+
 void PublishEvent(enum_t sig)
 {
     auto e = Q_NEW(QP::QEvt, sig);
-    QP::QF::PUBLISH(e, nullptr);
+    PublishEvent(e);
 }
 
 void PublishEvent(QP::QEvt const* const e)
 {
+    CaptureOnPublish(e);
     QP::QF::PUBLISH(e, nullptr);
 }
 
+void PostAndProcess(QP::QEvt const* const e, QP::QActive* dest)
+{
+    CaptureOnPost(e, dest);
+    dest->POST(e, nullptr);
+    ProcessEvents();
+}
+
 void PublishAndProcess(enum_t sig, PublishedEventRecorder* recorder)
 {
     if (recorder != nullptr) {
@@ -219,6 +522,202 @@ void CreatePoolConfigsFromArg(const MemPoolConfigs& pubSubEventMemPoolConfigs)
     }
 }
 
+size_t PoolEventsInUse()
+{
+    size_t inUse = 0;
+    if (l_pubSubEventMemPoolConfigs != nullptr) {
+        for (size_t i = 0; i < l_pubSubEventMemPoolConfigs->size(); ++i) {
+            inUse += l_pubSubEventMemPoolConfigs->at(i).config.numberOfEvents -
+                     PoolFreeCount(i);
+        }
+    }
+    return inUse + overflow::LiveBlocks();
+}
+
+// the current test's group, or empty outside of a cpputest test run.
+static SimpleString CurrentTestGroup()
+{
+    const UtestShell* current = UtestShell::getCurrent();
+    return (current != nullptr) ? current->getGroup() : SimpleString("");
+}
+
+// QF state included in every checkpoint, ahead of the user regions.
+// The first regions are QF's own: the ready set, registry and time
+// event heads.
+static constexpr size_t QF_REGION_COUNT           = 7;
+static constexpr size_t QF_FRAMEWORK_REGION_COUNT = 3;
+static std::array<MemoryRegion, QF_REGION_COUNT> QfRegions()
+{
+    using namespace QP;
+    const auto port = GetPortStateRegions();
+#if QP_VERSION < 810
+    auto& registry  = QActive::registry_;
+    auto& timeHeads = QTimeEvt::timeEvtHead_;
+#else
+    auto& registry  = QActive_registry_;
+    auto& timeHeads = QTimeEvt_head_;
+#endif
+
+    return {{
+      {static_cast<void*>(&cpputest_readySet_),
+       sizeof(cpputest_readySet_)},
+      {static_cast<void*>(&registry[0]), sizeof(registry)},
+      {static_cast<void*>(&timeHeads[0]), sizeof(timeHeads)},
+      {static_cast<void*>(l_subscriberStorage->data()),
+       l_subscriberStorage->size() * sizeof(QSubscrList)},
+      TimingWheelRegion(),
+      {port[0].address, port[0].size},
+      {port[1].address, port[1].size},
+    }};
+}
+
+void MeasureQfRam(ram::Footprint* footprint)
+{
+    if (l_subscriberStorage == nullptr) {
+        return;
+    }
+
+    for (const auto& pool : *l_pubSubEventMemPoolConfigs) {
+        footprint->poolBytes += pool.storageSize;
+    }
+    footprint->subscriberBytes =
+      l_subscriberStorage->size() * sizeof(QP::QSubscrList);
+
+    const auto regions = QfRegions();
+    for (size_t i = 0; i < QF_FRAMEWORK_REGION_COUNT; ++i) {
+        footprint->frameworkBytes += regions[i].size;
+    }
+}
+
+template <class Func>
+static void ForEachCheckpointRegion(Func func)
+{
+    for (const auto& region : QfRegions()) {
+        func(region);
+    }
+    for (size_t i = 0; i < l_checkpoint.userRegionCount; ++i) {
+        func(l_checkpoint.userRegions[i]);
+    }
+}
+
+void Checkpoint(const MemoryRegions& userRegions)
+{
+    // checked in every build, as a checkpoint taken anyway would
+    // corrupt the pools on each Restore().
+    if ((l_subscriberStorage == nullptr) ||
+        (l_pubSubEventMemPoolConfigs == nullptr)) {
+        FAIL("qf_ctrl::Checkpoint() requires qf_ctrl::Setup()");
+    }
+
+    // in flight pool events can not be captured, as restoring would
+    // need to rebuild each pool's free list and the overflow slab.
+    if (PoolEventsInUse() != 0U) {
+        FAIL("qf_ctrl::Checkpoint() requires every pool event to be free, "
+             "including pool overflow events");
+    }
+
+    DiscardCheckpoint();
+
+    const SimpleString group = CurrentTestGroup();
+    const size_t groupSize   = std::strlen(group.asCharString()) + 1;
+    l_checkpoint.group       = static_cast<char*>(std::malloc(groupSize));
+    assert(l_checkpoint.group != nullptr);
+    std::memcpy(l_checkpoint.group, group.asCharString(), groupSize);
+
+    l_checkpoint.userRegionCount = userRegions.size();
+    if (!userRegions.empty()) {
+        l_checkpoint.userRegions = static_cast<MemoryRegion*>(
+          std::malloc(userRegions.size() * sizeof(MemoryRegion)));
+        assert(l_checkpoint.userRegions != nullptr);
+        std::copy(userRegions.begin(), userRegions.end(),
+                  l_checkpoint.userRegions);
+    }
+    l_checkpoint.subscriberCount = l_subscriberStorage->size();
+    l_checkpoint.poolCount       = l_pubSubEventMemPoolConfigs->size();
+
+    size_t byteCount = 0;
+    ForEachCheckpointRegion(
+      [&byteCount](const MemoryRegion& region) { byteCount += region.size; });
+    l_checkpoint.bytes     = static_cast<unsigned char*>(std::malloc(byteCount));
+    l_checkpoint.byteCount = byteCount;
+    assert(l_checkpoint.bytes != nullptr);
+
+    size_t offset = 0;
+    ForEachCheckpointRegion([&offset](const MemoryRegion& region) {
+        std::memcpy(&l_checkpoint.bytes[offset], region.address, region.size);
+        offset += region.size;
+    });
+
+    // with all pool blocks free, the stimuli hold only static events
+    l_checkpoint.tickCount        = l_tickCount;
+    l_checkpoint.heldTicks        = l_heldTicks;
+    l_checkpoint.timelineSequence = l_timelineSequence;
+    l_checkpoint.timelineCount    = l_timeline->size();
+    if (!l_timeline->empty()) {
+        l_checkpoint.timeline = static_cast<TimelineEntry*>(
+          std::malloc(l_timeline->size() * sizeof(TimelineEntry)));
+        assert(l_checkpoint.timeline != nullptr);
+        std::copy(l_timeline->begin(), l_timeline->end(),
+                  l_checkpoint.timeline);
+    }
+}
+
+void Restore()
+{
+    using namespace QP;
+
+    assert(l_checkpoint.bytes != nullptr);
+    assert(l_subscriberStorage != nullptr);
+    assert(l_pubSubEventMemPoolConfigs != nullptr);
+
+    // Setup() must have matched the checkpoint's configuration
+    assert(l_subscriberStorage->size() == l_checkpoint.subscriberCount);
+    assert(l_pubSubEventMemPoolConfigs->size() == l_checkpoint.poolCount);
+
+    // all pool blocks were free at the checkpoint, so fresh pools
+    // are equivalent.
+    leaks::OnSetup();
+    lifetime::OnSetup();
+    QF::priv_.maxPool_ = 0U;
+    for (auto& config : *l_pubSubEventMemPoolConfigs) {
+        QF::poolInit(config.storage, config.storageSize,
+                     config.config.eventSize);
+    }
+
+    size_t offset = 0;
+    ForEachCheckpointRegion([&offset](const MemoryRegion& region) {
+        std::memcpy(region.address, &l_checkpoint.bytes[offset], region.size);
+        offset += region.size;
+    });
+    assert(offset == l_checkpoint.byteCount);
+
+    // the timeline is still in heap order, as captured
+    l_tickCount        = l_checkpoint.tickCount;
+    l_heldTicks        = l_checkpoint.heldTicks;
+    l_timelineSequence = l_checkpoint.timelineSequence;
+    l_timeline->assign(l_checkpoint.timeline,
+                       l_checkpoint.timeline + l_checkpoint.timelineCount);
+}
+
+bool HasCheckpoint()
+{
+    if (l_checkpoint.bytes == nullptr) {
+        return false;
+    }
+
+    const SimpleString group = CurrentTestGroup();
+    return std::strcmp(group.asCharString(), l_checkpoint.group) == 0;
+}
+
+void DiscardCheckpoint()
+{
+    std::free(l_checkpoint.group);
+    std::free(l_checkpoint.userRegions);
+    std::free(l_checkpoint.bytes);
+    std::free(l_checkpoint.timeline);
+    l_checkpoint = CheckpointState {};
+}
+
 const char* GetVersion()
 {
     return CPPUTEST_FOR_QPCPP_LIB_VERSION;
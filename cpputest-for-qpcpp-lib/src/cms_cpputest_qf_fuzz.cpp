@@ -0,0 +1,190 @@
+/// @brief Fuzzing harness driving active objects through qf_ctrl.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_fuzz.hpp"
+#include "cms_cpputest_qf_capture_hooks.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace cms {
+namespace test {
+namespace fuzz {
+
+namespace {
+
+enum class Operation : uint8_t { POST, PUBLISH, TIME, PROCESS, COUNT };
+
+FuzzTarget* l_target = nullptr;
+
+// sequential reader over the fuzzer input
+class InputReader {
+public:
+    InputReader(const uint8_t* data, size_t size) :
+        m_data(data), m_size(size), m_offset(0)
+    {
+    }
+
+    bool isEmpty() const { return m_offset >= m_size; }
+
+    bool read(uint8_t* value)
+    {
+        if (isEmpty()) {
+            return false;
+        }
+        *value = m_data[m_offset++];
+        return true;
+    }
+
+    // copy up to 'size' bytes, zero filling once the input runs out.
+    void readPayload(uint8_t* dest, size_t size)
+    {
+        const size_t available = std::min(size, m_size - m_offset);
+        std::memcpy(dest, &m_data[m_offset], available);
+        std::memset(dest + available, 0, size - available);
+        m_offset += available;
+    }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    size_t m_offset;
+};
+
+QP::QEvt const* NewFuzzEvent(InputReader& reader,
+                             const std::vector<FuzzSignal>& signals)
+{
+    uint8_t index = 0;
+    if (signals.empty() || !reader.read(&index)) {
+        return nullptr;
+    }
+
+    const FuzzSignal& signal = signals[index % signals.size()];
+    assert(signal.eventSize >= sizeof(QP::QEvt));
+
+    QP::QEvt* e = QP::QF::newX_(static_cast<uint_fast16_t>(signal.eventSize),
+                                QP::QF::NO_MARGIN, signal.sig);
+    reader.readPayload(reinterpret_cast<uint8_t*>(e) + sizeof(QP::QEvt),
+                       signal.eventSize - sizeof(QP::QEvt));
+    return e;
+}
+
+}   // namespace
+
+void Initialize(const FuzzTarget& target)
+{
+    assert(l_target == nullptr);
+    assert(target.startActiveObjects != nullptr);
+    assert(target.postTarget != nullptr);
+
+    l_target = new FuzzTarget(target);
+
+    qf_ctrl::Setup(target.maxPubSubSignalValue, target.ticksPerSecond);
+    target.startActiveObjects();
+    qf_ctrl::ProcessEvents();
+    qf_ctrl::Checkpoint(target.regions);
+}
+
+InputResult RunOneInput(const uint8_t* data, size_t size)
+{
+    assert(l_target != nullptr);
+
+    qf_ctrl::Restore();
+
+    InputReader reader(data, size);
+    uint8_t opByte = 0;
+    bool truncated = false;
+    while (!truncated && reader.read(&opByte)) {
+        const auto op = static_cast<Operation>(
+          opByte % static_cast<uint8_t>(Operation::COUNT));
+        switch (op) {
+            case Operation::POST: {
+                auto e = NewFuzzEvent(reader, l_target->postSignals);
+                truncated = (e == nullptr);
+                if (e != nullptr) {
+                    // a full queue drops the event (QP recycles it)
+                    qf_ctrl::CaptureOnPost(e, l_target->postTarget);
+                    static_cast<void>(
+                      l_target->postTarget->POST_X(e, 1U, nullptr));
+                }
+            } break;
+            case Operation::PUBLISH: {
+                auto e    = NewFuzzEvent(reader, l_target->publishSignals);
+                truncated = (e == nullptr);
+                if (e != nullptr) {
+                    qf_ctrl::PublishAndProcess(e);
+                }
+            } break;
+            case Operation::TIME: {
+                uint8_t low  = 0;
+                uint8_t high = 0;
+                truncated    = !reader.read(&low) || !reader.read(&high);
+                if (!truncated) {
+                    const uint32_t step =
+                      (static_cast<uint32_t>(high) << 8U | low) %
+                      (static_cast<uint32_t>(l_target->maxTimeStepMs) + 1U);
+                    qf_ctrl::MoveTimeForward(std::chrono::milliseconds(step));
+                }
+            } break;
+            case Operation::PROCESS:
+            default:
+                qf_ctrl::ProcessEvents();
+                break;
+        }
+    }
+
+    qf_ctrl::ProcessEvents();
+    return (qf_ctrl::PoolEventsInUse() == 0U) ? InputResult::OK
+                                               : InputResult::POOL_LEAK;
+}
+
+int TestOneInput(const uint8_t* data, size_t size)
+{
+    if (RunOneInput(data, size) == InputResult::POOL_LEAK) {
+        std::fprintf(stderr, "cms::test::fuzz: pool event leak\n");
+        std::abort();
+    }
+    return 0;
+}
+
+void Shutdown()
+{
+    assert(l_target != nullptr);
+
+    // return to the (leak free) checkpoint before the Teardown leak check
+    qf_ctrl::Restore();
+    qf_ctrl::DiscardCheckpoint();
+    qf_ctrl::Teardown();
+
+    delete l_target;
+    l_target = nullptr;
+}
+
+}   // namespace fuzz
+}   // namespace test
+}   // namespace cms
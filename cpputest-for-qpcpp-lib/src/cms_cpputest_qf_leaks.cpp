@@ -0,0 +1,198 @@
+/// @brief Pool event leak tracking: where each live event was allocated.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_leaks.hpp"
+#include "cms_cpputest_qf_leaks_hooks.hpp"
+#include "cms_cpputest_qf_block_table.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include <algorithm>
+#include <vector>
+#ifdef CMS_LEAK_TRACKING_BACKTRACE
+#include <execinfo.h>
+#endif
+
+namespace cms {
+namespace test {
+namespace leaks {
+
+static BlockTable<LiveBlock, CMS_LEAK_TRACKING_CAPACITY> l_table;
+
+static size_t l_untrackedCount = 0;
+static uint32_t l_sequence     = 0;
+static bool l_enabled          = false;
+
+static void OnGet(void*, std::uint_fast8_t poolNum, void const* block)
+{
+    ++l_sequence;
+    LiveBlock* inserted = l_table.Insert(block);
+    if (inserted == nullptr) {
+        ++l_untrackedCount;
+        return;
+    }
+
+    LiveBlock& entry = *inserted;
+    entry.tick       = qf_ctrl::TicksSinceSetup();
+    entry.sequence   = l_sequence;
+    entry.poolNum    = static_cast<uint8_t>(poolNum);
+    entry.prio       = static_cast<uint8_t>(QP::GetActivePriority());
+#ifdef CMS_LEAK_TRACKING_BACKTRACE
+    entry.frameCount = static_cast<uint8_t>(
+      backtrace(entry.frames, CMS_LEAK_TRACKING_BACKTRACE_DEPTH));
+#endif
+}
+
+static void OnPut(void*, std::uint_fast8_t, void const* block)
+{
+    LiveBlock* entry = l_table.Find(block);
+    if (entry != nullptr) {   // else untracked, or allocated before Enable()
+        l_table.Remove(entry);
+    }
+}
+
+static const QP::PoolObserver l_observer = {&OnGet, &OnPut, nullptr};
+
+static void Forget()
+{
+    l_table.Clear();
+    l_untrackedCount = 0;
+    l_sequence       = 0;
+}
+
+void OnSetup()
+{
+    Forget();
+#ifdef CMS_ENABLE_POOL_LEAK_TRACKING
+    Enable();
+#endif
+}
+
+void Enable()
+{
+    if (!l_enabled) {
+        l_enabled = QP::AddPoolObserver(&l_observer);
+    }
+}
+
+void Disable()
+{
+    if (l_enabled) {
+        QP::RemovePoolObserver(&l_observer);
+        l_enabled = false;
+    }
+}
+
+bool IsEnabled()
+{
+    return l_enabled;
+}
+
+size_t LiveCount()
+{
+    return l_table.Count();
+}
+
+static enum_t SignalOf(LiveBlock const& entry)
+{
+    // the block is still allocated, so still holds its event
+    return static_cast<enum_t>(static_cast<QP::QEvt const*>(entry.block)->sig);
+}
+
+size_t LiveCount(enum_t sig)
+{
+    if (l_table.Count() == 0U) {
+        return 0;
+    }
+
+    return static_cast<size_t>(
+      std::count_if(l_table.begin(), l_table.end(), [sig](const LiveBlock& entry) {
+          return (entry.block != nullptr) && (SignalOf(entry) == sig);
+      }));
+}
+
+size_t UntrackedCount()
+{
+    return l_untrackedCount;
+}
+
+LiveBlock const* Find(QP::QEvt const* e)
+{
+    return l_table.Find(e);
+}
+
+void Report(std::FILE* out)
+{
+    std::vector<LiveBlock const*> live;
+    live.reserve(l_table.Count());
+    for (auto& entry : l_table) {
+        if (entry.block != nullptr) {
+            live.push_back(&entry);
+        }
+    }
+
+    std::sort(live.begin(), live.end(), [](LiveBlock const* a, LiveBlock const* b) {
+        const enum_t sigA = SignalOf(*a);
+        const enum_t sigB = SignalOf(*b);
+        if (sigA != sigB) {
+            return sigA < sigB;
+        }
+        if (a->prio != b->prio) {
+            return a->prio < b->prio;
+        }
+        return a->sequence < b->sequence;
+    });
+
+    fprintf(out, "Live pool events: %zu\n", live.size());
+    for (size_t i = 0; i < live.size();) {
+        LiveBlock const& first = *live[i];
+        size_t count           = 0;
+        while ((i < live.size()) && (SignalOf(*live[i]) == SignalOf(first)) &&
+               (live[i]->prio == first.prio)) {
+            ++count;
+            ++i;
+        }
+
+        fprintf(out, "  sig %d x%zu, allocated by ", SignalOf(first), count);
+        if (first.prio == 0U) {
+            fprintf(out, "the test");
+        }
+        else {
+            fprintf(out, "active object prio %u", first.prio);
+        }
+        fprintf(out,
+                " (first: allocation #%u at tick %llu, pool %u)\n",
+                first.sequence, static_cast<unsigned long long>(first.tick),
+                first.poolNum);
+#ifdef CMS_LEAK_TRACKING_BACKTRACE
+        fflush(out);
+        backtrace_symbols_fd(first.frames, first.frameCount, fileno(out));
+#endif
+    }
+
+    if (l_untrackedCount != 0U) {
+        fprintf(out, "  and %zu untracked allocations\n", l_untrackedCount);
+    }
+}
+
+}   // namespace leaks
+}   // namespace test
+}   // namespace cms
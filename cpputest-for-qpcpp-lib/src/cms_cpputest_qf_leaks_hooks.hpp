@@ -0,0 +1,41 @@
+/// @brief qf_ctrl internal interface to pool event leak tracking.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_LEAKS_HOOKS_HPP
+#define CMS_CPPUTEST_QF_LEAKS_HOOKS_HPP
+
+#include "cms_cpputest_qf_leaks.hpp"
+
+namespace cms {
+namespace test {
+namespace leaks {
+
+// forget the tracked blocks, all pools being free again, and enable
+// tracking if built with CMS_ENABLE_POOL_LEAK_TRACKING.
+void OnSetup();
+
+}   // namespace leaks
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_LEAKS_HOOKS_HPP
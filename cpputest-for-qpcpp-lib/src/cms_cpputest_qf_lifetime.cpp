@@ -0,0 +1,277 @@
+/// @brief Pool event lifetime and queueing delay histograms, by signal.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_lifetime.hpp"
+#include "cms_cpputest_qf_lifetime_hooks.hpp"
+#include "cms_cpputest_qf_block_table.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+namespace cms {
+namespace test {
+namespace lifetime {
+
+namespace {
+
+struct Stamp {
+    void const* block;
+    uint64_t allocTick;
+    uint64_t allocNs;
+    uint64_t lastTick;   ///< the allocation, then each dispatch
+    uint64_t lastNs;
+};
+
+}   // namespace
+
+static BlockTable<Stamp, CMS_LIFETIME_CAPACITY> l_table;
+
+static size_t l_unstampedCount = 0;
+static bool l_enabled          = false;
+
+// by signal, grown as signals are seen. The histograms outlive the tests,
+// so are allocated with malloc, out of sight of the cpputest leak detector.
+static SignalLifetimes* l_signals = nullptr;
+static size_t l_signalCount       = 0;
+
+static uint64_t HostNs()
+{
+    return static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch())
+        .count());
+}
+
+// \return nullptr if out of memory.
+static SignalLifetimes* SignalOf(void const* block)
+{
+    // the block is still allocated, so still holds its event
+    const auto sig =
+      static_cast<size_t>(static_cast<QP::QEvt const*>(block)->sig);
+    if (sig >= l_signalCount) {
+        const size_t count = std::max(sig + 1U, 2U * l_signalCount);
+        auto signals       = static_cast<SignalLifetimes*>(
+          std::realloc(l_signals, count * sizeof(SignalLifetimes)));
+        if (signals == nullptr) {
+            return nullptr;
+        }
+        std::memset(&signals[l_signalCount], 0,
+                    (count - l_signalCount) * sizeof(SignalLifetimes));
+        l_signals     = signals;
+        l_signalCount = count;
+    }
+    return &l_signals[sig];
+}
+
+static void OnGet(void*, std::uint_fast8_t, void const* block)
+{
+    Stamp* inserted = l_table.Insert(block);
+    if (inserted == nullptr) {
+        ++l_unstampedCount;
+        return;
+    }
+
+    // QF sets the signal after the get, so it is read later
+    Stamp& stamp    = *inserted;
+    stamp.allocTick = qf_ctrl::TicksSinceSetup();
+    stamp.allocNs   = HostNs();
+    stamp.lastTick  = stamp.allocTick;
+    stamp.lastNs    = stamp.allocNs;
+}
+
+static void OnPut(void*, std::uint_fast8_t, void const* block)
+{
+    Stamp* stamp = l_table.Find(block);
+    if (stamp == nullptr) {
+        return;   // unstamped, or allocated before Enable()
+    }
+
+    SignalLifetimes* signal = SignalOf(block);
+    if (signal != nullptr) {
+        signal->lifetimeTicks.Add(qf_ctrl::TicksSinceSetup() -
+                                  stamp->allocTick);
+        signal->lifetimeNs.Add(HostNs() - stamp->allocNs);
+    }
+    l_table.Remove(stamp);
+}
+
+static void BeforeDispatch(void*, QP::QActive const*, QP::QEvt const* e)
+{
+    Stamp* found            = l_table.Find(e);
+    SignalLifetimes* signal = (found == nullptr) ? nullptr : SignalOf(e);
+    if (signal == nullptr) {
+        return;   // not a stamped pool event, or out of memory
+    }
+
+    Stamp& stamp        = *found;
+    const uint64_t tick = qf_ctrl::TicksSinceSetup();
+    const uint64_t ns   = HostNs();
+    signal->queueTicks.Add(tick - stamp.lastTick);
+    signal->queueNs.Add(ns - stamp.lastNs);
+    stamp.lastTick = tick;
+    stamp.lastNs   = ns;
+}
+
+static const QP::PoolObserver l_poolObserver = {&OnGet, &OnPut, nullptr};
+static const QP::DispatchObserver l_dispatchObserver = {&BeforeDispatch,
+                                                        nullptr, nullptr};
+
+void Histogram::Add(uint64_t value)
+{
+    size_t bucket = 0U;
+    for (uint64_t rest = value; (rest != 0U) && (bucket < BUCKETS - 1U);
+         rest >>= 1U) {
+        ++bucket;
+    }
+
+    ++buckets[bucket];
+    ++count;
+    sum += value;
+    max = std::max(max, value);
+}
+
+uint64_t Histogram::Percentile(double percent) const
+{
+    const auto wanted = static_cast<uint64_t>(
+      static_cast<double>(count) * percent / 100.0 + 0.999999);
+    uint64_t seen = 0U;
+    for (size_t bucket = 0U; bucket < BUCKETS; ++bucket) {
+        seen += buckets[bucket];
+        if ((seen != 0U) && (seen >= wanted)) {
+            const uint64_t top = (bucket == 0U)
+                                   ? 0U
+                                   : ((uint64_t {1} << bucket) - 1U);
+            return ((bucket == BUCKETS - 1U) || (top > max)) ? max : top;
+        }
+    }
+    return 0U;
+}
+
+void OnSetup()
+{
+    l_table.Clear();
+}
+
+void Enable()
+{
+    if (l_enabled) {
+        return;
+    }
+
+    if (QP::AddPoolObserver(&l_poolObserver)) {
+        if (QP::AddDispatchObserver(&l_dispatchObserver)) {
+            l_enabled = true;
+        }
+        else {
+            QP::RemovePoolObserver(&l_poolObserver);
+        }
+    }
+}
+
+void Disable()
+{
+    if (l_enabled) {
+        QP::RemoveDispatchObserver(&l_dispatchObserver);
+        QP::RemovePoolObserver(&l_poolObserver);
+        l_enabled = false;
+    }
+}
+
+bool IsEnabled()
+{
+    return l_enabled;
+}
+
+void Reset()
+{
+    std::free(l_signals);
+    l_signals        = nullptr;
+    l_signalCount    = 0;
+    l_unstampedCount = 0;
+}
+
+SignalLifetimes const* Find(enum_t sig)
+{
+    if ((sig < 0) || (static_cast<size_t>(sig) >= l_signalCount)) {
+        return nullptr;
+    }
+
+    SignalLifetimes const& signal = l_signals[static_cast<size_t>(sig)];
+    if ((signal.lifetimeTicks.count == 0U) && (signal.queueTicks.count == 0U)) {
+        return nullptr;
+    }
+    return &signal;
+}
+
+size_t UnstampedCount()
+{
+    return l_unstampedCount;
+}
+
+void Report(std::FILE* out)
+{
+    std::vector<enum_t> sigs;
+    for (size_t sig = 0U; sig < l_signalCount; ++sig) {
+        if (Find(static_cast<enum_t>(sig)) != nullptr) {
+            sigs.push_back(static_cast<enum_t>(sig));
+        }
+    }
+
+    std::sort(sigs.begin(), sigs.end(), [](enum_t a, enum_t b) {
+        SignalLifetimes const& sa = *Find(a);
+        SignalLifetimes const& sb = *Find(b);
+        if (sa.queueTicks.max != sb.queueTicks.max) {
+            return sa.queueTicks.max > sb.queueTicks.max;
+        }
+        return sa.queueNs.max > sb.queueNs.max;
+    });
+
+    fprintf(out, "Pool event lifetimes by signal: %zu signals\n", sigs.size());
+    for (enum_t sig : sigs) {
+        SignalLifetimes const& s = *Find(sig);
+        fprintf(out,
+                "  sig %d: %llu events, lifetime ticks p50<=%llu p99<=%llu "
+                "max %llu (host max %.1f us), queued ticks p50<=%llu "
+                "p99<=%llu max %llu (host max %.1f us)\n",
+                sig, static_cast<unsigned long long>(s.lifetimeTicks.count),
+                static_cast<unsigned long long>(s.lifetimeTicks.Percentile(50.0)),
+                static_cast<unsigned long long>(s.lifetimeTicks.Percentile(99.0)),
+                static_cast<unsigned long long>(s.lifetimeTicks.max),
+                static_cast<double>(s.lifetimeNs.max) / 1000.0,
+                static_cast<unsigned long long>(s.queueTicks.Percentile(50.0)),
+                static_cast<unsigned long long>(s.queueTicks.Percentile(99.0)),
+                static_cast<unsigned long long>(s.queueTicks.max),
+                static_cast<double>(s.queueNs.max) / 1000.0);
+    }
+
+    if (l_unstampedCount != 0U) {
+        fprintf(out, "  and %zu unstamped allocations\n", l_unstampedCount);
+    }
+}
+
+}   // namespace lifetime
+}   // namespace test
+}   // namespace cms
@@ -0,0 +1,316 @@
+/// @brief Per test cost metrics: wall time, QF traffic and peak usage.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_metrics.hpp"
+#include "cms_cpputest_qf_metrics_hooks.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include "CppUTest/TestHarness.h"
+
+namespace cms {
+namespace test {
+namespace metrics {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t NO_TICK = UINT64_MAX;
+
+// the test being measured
+TestMetrics l_current       = {};
+Clock::time_point l_start   = {};
+uint64_t l_publishedAtStart = 0;
+uint64_t l_lastActiveTick   = NO_TICK;
+size_t l_poolInUse          = 0;
+bool l_setUp                = false;
+bool l_observing            = false;
+
+// test records outlive the tests, so are allocated with malloc, out of
+// sight of the cpputest leak detector.
+struct TestRecord {
+    char group[64];
+    char name[128];
+    TestMetrics metrics;
+};
+
+TestRecord* l_records = nullptr;
+size_t l_recordCount  = 0;
+size_t l_recordLimit  = 0;
+size_t l_tests        = 0;   // including those beyond the records
+TestMetrics l_suite   = {};
+size_t l_idleTests    = 0;
+
+void AfterDispatch(void*, QP::QActive const*, QP::QEvt const*)
+{
+    ++l_current.dispatched;
+
+    const uint64_t tick = qf_ctrl::TicksSinceSetup();
+    if (tick != l_lastActiveTick) {
+        ++l_current.activeTicks;
+        l_lastActiveTick = tick;
+    }
+}
+
+void OnPoolGet(void*, std::uint_fast8_t, void const*)
+{
+    ++l_poolInUse;
+    l_current.poolPeak = std::max(l_current.poolPeak, l_poolInUse);
+}
+
+void OnPoolPut(void*, std::uint_fast8_t, void const*)
+{
+    // blocks leaked by an earlier test were freed by its teardown
+    if (l_poolInUse != 0U) {
+        --l_poolInUse;
+    }
+}
+
+const QP::DispatchObserver l_dispatchObserver = {nullptr, &AfterDispatch,
+                                                 nullptr};
+const QP::PoolObserver l_poolObserver         = {&OnPoolGet, &OnPoolPut,
+                                                 nullptr};
+
+void StartObserving()
+{
+    if (!l_observing) {
+        l_observing = QP::AddDispatchObserver(&l_dispatchObserver) &&
+                      QP::AddPoolObserver(&l_poolObserver);
+        assert(l_observing);
+    }
+}
+
+void StopObserving()
+{
+    if (l_observing) {
+        QP::RemoveDispatchObserver(&l_dispatchObserver);
+        QP::RemovePoolObserver(&l_poolObserver);
+        l_observing = false;
+    }
+}
+
+size_t QueuePeak()
+{
+    size_t peak = 0;
+    for (std::uint_fast8_t prio = 1U; prio <= QF_MAX_ACTIVE; ++prio) {
+        const size_t length = QP::GetQueueLength(prio);
+        if (length == 0U) {
+            continue;
+        }
+
+        // the queue holds 'length' events besides the front event
+#if QP_VERSION > 800
+        const size_t minFree = QP::QActive::getQueueMin(prio);
+#else
+        const size_t minFree = QP::QF::getQueueMin(prio);
+#endif
+        if (minFree <= length + 1U) {
+            peak = std::max(peak, length + 1U - minFree);
+        }
+    }
+    return peak;
+}
+
+bool IsIdle(const TestMetrics& m)
+{
+    return (m.ticks >= CMS_METRICS_IDLE_TICKS_MIN) &&
+           (m.activeTicks * CMS_METRICS_IDLE_TICKS_RATIO < m.ticks);
+}
+
+void AppendRecord(const char* group, const char* name, const TestMetrics& m)
+{
+    ++l_tests;
+    l_suite.seconds += m.seconds;
+    l_suite.dispatched += m.dispatched;
+    l_suite.published += m.published;
+    l_suite.ticks += m.ticks;
+    l_suite.activeTicks += m.activeTicks;
+    l_suite.poolPeak  = std::max(l_suite.poolPeak, m.poolPeak);
+    l_suite.queuePeak = std::max(l_suite.queuePeak, m.queuePeak);
+    if (m.idleTicks) {
+        ++l_idleTests;
+    }
+
+    if (l_recordCount == CMS_METRICS_MAX_TEST_RECORDS) {
+        return;
+    }
+
+    if (l_recordCount == l_recordLimit) {
+        const size_t limit = (l_recordLimit == 0U) ? 256U : 2U * l_recordLimit;
+        auto records       = static_cast<TestRecord*>(
+          std::realloc(l_records, limit * sizeof(TestRecord)));
+        if (records == nullptr) {
+            return;
+        }
+        l_records     = records;
+        l_recordLimit = limit;
+    }
+
+    TestRecord& record = l_records[l_recordCount++];
+    std::snprintf(record.group, sizeof(record.group), "%s", group);
+    std::snprintf(record.name, sizeof(record.name), "%s", name);
+    record.metrics = m;
+}
+
+// test group and names are C++ identifiers, but escape them regardless
+void PrintJsonString(std::FILE* out, const char* text)
+{
+    std::fputc('"', out);
+    for (const char* c = text; *c != '\0'; ++c) {
+        if ((*c == '"') || (*c == '\\')) {
+            std::fputc('\\', out);
+        }
+        if (static_cast<unsigned char>(*c) >= 0x20U) {
+            std::fputc(*c, out);
+        }
+    }
+    std::fputc('"', out);
+}
+
+void PrintJsonMetrics(std::FILE* out, const TestMetrics& m)
+{
+    std::fprintf(out,
+                 "\"seconds\": %.6f, \"dispatched\": %llu, \"published\": %llu, "
+                 "\"ticks\": %llu, \"activeTicks\": %llu, \"poolPeak\": %zu, "
+                 "\"queuePeak\": %zu",
+                 m.seconds, static_cast<unsigned long long>(m.dispatched),
+                 static_cast<unsigned long long>(m.published),
+                 static_cast<unsigned long long>(m.ticks),
+                 static_cast<unsigned long long>(m.activeTicks), m.poolPeak,
+                 m.queuePeak);
+}
+
+}   // namespace
+
+void BeginTest()
+{
+    StartObserving();
+    l_current          = {};
+    l_start            = Clock::now();
+    l_publishedAtStart = QP::GetPublishCount();
+    l_lastActiveTick   = NO_TICK;
+    l_poolInUse        = 0;
+}
+
+TestMetrics Current()
+{
+    TestMetrics m = l_current;
+    m.seconds =
+      std::chrono::duration<double>(Clock::now() - l_start).count();
+    m.published = QP::GetPublishCount() - l_publishedAtStart;
+    if (l_setUp) {
+        m.ticks += qf_ctrl::TicksSinceSetup();
+        m.queuePeak = std::max(m.queuePeak, QueuePeak());
+    }
+    m.idleTicks = IsIdle(m);
+    return m;
+}
+
+void EndTest(const char* group, const char* name)
+{
+    assert((group != nullptr) && (name != nullptr));
+    AppendRecord(group, name, Current());
+}
+
+void Reset()
+{
+    std::free(l_records);
+    l_records     = nullptr;
+    l_recordCount = 0;
+    l_recordLimit = 0;
+    l_tests       = 0;
+    l_suite       = {};
+    l_idleTests   = 0;
+}
+
+void OnSetup()
+{
+    l_setUp          = true;
+    l_lastActiveTick = NO_TICK;
+}
+
+void OnTeardown()
+{
+    if (!l_setUp) {
+        return;
+    }
+
+    l_current.ticks += qf_ctrl::TicksSinceSetup();
+    l_current.queuePeak = std::max(l_current.queuePeak, QueuePeak());
+    l_setUp             = false;
+}
+
+void ReportJson(std::FILE* out)
+{
+    assert(out != nullptr);
+
+    std::sort(l_records, l_records + l_recordCount,
+              [](const TestRecord& a, const TestRecord& b) {
+                  return a.metrics.seconds > b.metrics.seconds;
+              });
+
+    std::fprintf(out, "{\n  \"tests\": [");
+    for (size_t i = 0; i < l_recordCount; ++i) {
+        const TestRecord& record = l_records[i];
+        std::fprintf(out, "%s\n    {\"group\": ", (i == 0U) ? "" : ",");
+        PrintJsonString(out, record.group);
+        std::fprintf(out, ", \"name\": ");
+        PrintJsonString(out, record.name);
+        std::fprintf(out, ", ");
+        PrintJsonMetrics(out, record.metrics);
+        std::fprintf(out, ", \"idleTicks\": %s}",
+                     record.metrics.idleTicks ? "true" : "false");
+    }
+
+    std::fprintf(out, "\n  ],\n  \"suite\": {\"tests\": %zu, ", l_tests);
+    PrintJsonMetrics(out, l_suite);
+    std::fprintf(out, ", \"idleTickTests\": %zu}\n}\n", l_idleTests);
+}
+
+MetricsPlugin::MetricsPlugin() :
+    TestPlugin("CmsTestMetrics")
+{
+}
+
+MetricsPlugin::~MetricsPlugin()
+{
+    StopObserving();
+}
+
+void MetricsPlugin::preTestAction(UtestShell&, TestResult&)
+{
+    BeginTest();
+}
+
+void MetricsPlugin::postTestAction(UtestShell& test, TestResult&)
+{
+    EndTest(test.getGroup().asCharString(), test.getName().asCharString());
+}
+
+}   // namespace metrics
+}   // namespace test
+}   // namespace cms
@@ -0,0 +1,180 @@
+/// @brief Opt in overflow of exhausted event pools into a secondary slab.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_pool_overflow.hpp"
+#include "cms_cpputest_qf_pool_overflow_hooks.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+
+namespace cms {
+namespace test {
+namespace overflow {
+
+// Each pool overflows into its own slab: blocks carved from the shared
+// arena, recycled through a free list threaded through the free blocks.
+struct PoolSlab {
+    void* freeList;
+    size_t blockSize;
+    size_t slotSize;   // blockSize, aligned for any event
+    size_t overflows;
+    size_t liveBlocks;
+    size_t peakBlocks;
+};
+
+static std::array<PoolSlab, QF_MAX_EPOOL> l_slabs;
+static unsigned char* l_arena  = nullptr;
+static size_t l_arenaBytes     = 0;
+static size_t l_arenaUsed      = 0;
+static size_t l_arenaExhausted = 0;
+
+static void* Get(void*, std::uint_fast8_t poolNum, std::uint_fast16_t blockSize)
+{
+    assert((poolNum >= 1U) && (poolNum <= l_slabs.size()));
+    PoolSlab& slab = l_slabs[poolNum - 1U];
+    if (slab.blockSize == 0U) {
+        constexpr size_t ALIGN = alignof(std::max_align_t);
+        slab.blockSize         = blockSize;
+        slab.slotSize          = (blockSize + ALIGN - 1U) / ALIGN * ALIGN;
+    }
+
+    ++slab.overflows;
+    void* block = slab.freeList;
+    if (block != nullptr) {
+        std::memcpy(&slab.freeList, block, sizeof(slab.freeList));
+    }
+    else if (l_arenaUsed + slab.slotSize <= l_arenaBytes) {
+        block = &l_arena[l_arenaUsed];
+        l_arenaUsed += slab.slotSize;
+    }
+    else {
+        ++l_arenaExhausted;
+        return nullptr;
+    }
+
+    ++slab.liveBlocks;
+    if (slab.liveBlocks > slab.peakBlocks) {
+        slab.peakBlocks = slab.liveBlocks;
+    }
+    return block;
+}
+
+static bool Put(void*, std::uint_fast8_t poolNum, void* block)
+{
+    auto const* b = static_cast<unsigned char const*>(block);
+    if ((b < l_arena) || (b >= &l_arena[l_arenaUsed])) {
+        return false;   // the pool's own block
+    }
+
+    PoolSlab& slab = l_slabs[poolNum - 1U];
+    std::memcpy(block, &slab.freeList, sizeof(slab.freeList));
+    slab.freeList = block;
+    --slab.liveBlocks;
+    return true;
+}
+
+static const QP::PoolOverflow l_overflow = {&Get, &Put, nullptr};
+
+void Enable(size_t arenaBytes)
+{
+    assert(l_arena == nullptr);
+    assert(arenaBytes > 0U);
+
+    l_arena = static_cast<unsigned char*>(std::malloc(arenaBytes));
+    assert(l_arena != nullptr);
+    l_arenaBytes     = arenaBytes;
+    l_arenaUsed      = 0;
+    l_arenaExhausted = 0;
+    l_slabs.fill({});
+    QP::SetPoolOverflow(&l_overflow);
+}
+
+bool IsEnabled()
+{
+    return l_arena != nullptr;
+}
+
+PoolStats GetStats(size_t poolIndex)
+{
+    assert(poolIndex < l_slabs.size());
+    const PoolSlab& slab = l_slabs[poolIndex];
+    return {slab.blockSize, slab.overflows, slab.liveBlocks, slab.peakBlocks};
+}
+
+size_t LiveBlocks()
+{
+    size_t live = 0;
+    for (const auto& slab : l_slabs) {
+        live += slab.liveBlocks;
+    }
+    return live;
+}
+
+void Report(std::FILE* out)
+{
+    for (size_t i = 0; i < l_slabs.size(); ++i) {
+        const PoolSlab& slab = l_slabs[i];
+        if (slab.overflows == 0U) {
+            continue;
+        }
+
+        fprintf(out,
+                "Pool %zu (%zu byte events) overflowed %zu times, "
+                "peak extra demand %zu events (%zu bytes)\n",
+                i, slab.blockSize, slab.overflows, slab.peakBlocks,
+                slab.peakBlocks * slab.blockSize);
+    }
+
+    if (l_arenaExhausted != 0U) {
+        fprintf(out, "Pool overflow arena of %zu bytes exhausted %zu times\n",
+                l_arenaBytes, l_arenaExhausted);
+    }
+}
+
+void OnTeardown()
+{
+    if (!IsEnabled()) {
+        return;
+    }
+
+    bool overflowed = false;
+    for (const auto& slab : l_slabs) {
+        overflowed = overflowed || (slab.overflows != 0U);
+    }
+    if (overflowed) {
+        Report(stderr);
+    }
+
+    QP::SetPoolOverflow(nullptr);
+    l_slabs.fill({});
+    std::free(l_arena);
+    l_arena      = nullptr;
+    l_arenaBytes = 0;
+    l_arenaUsed  = 0;
+}
+
+}   // namespace overflow
+}   // namespace test
+}   // namespace cms
@@ -0,0 +1,41 @@
+/// @brief qf_ctrl internal interface to event pool overflow.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_POOL_OVERFLOW_HOOKS_HPP
+#define CMS_CPPUTEST_QF_POOL_OVERFLOW_HOOKS_HPP
+
+#include "cms_cpputest_qf_pool_overflow.hpp"
+
+namespace cms {
+namespace test {
+namespace overflow {
+
+// report any overflow of the ending test, then disable overflow and
+// release the arena.
+void OnTeardown();
+
+}   // namespace overflow
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_POOL_OVERFLOW_HOOKS_HPP
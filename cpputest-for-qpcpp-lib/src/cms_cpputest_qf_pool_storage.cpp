@@ -0,0 +1,139 @@
+/// @brief qf_ctrl internal event pool storage, reused across tests.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_pool_storage.hpp"
+#include <cstdio>
+#include <cstdlib>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#define CMS_POOL_STORAGE_MMAP_SUPPORTED
+#endif
+
+namespace cms {
+namespace test {
+namespace pool_storage {
+
+static constexpr size_t ALIGNMENT = 64U;
+
+static size_t AlignUp(size_t bytes)
+{
+    return (bytes + ALIGNMENT - 1U) / ALIGNMENT * ALIGNMENT;
+}
+
+// checked in every build type: pools without storage would corrupt
+// memory long before a test could report it.
+static void Require(bool condition, const char* message)
+{
+    if (!condition) {
+        std::fprintf(stderr, "cms::test::pool_storage: %s\n", message);
+        std::abort();
+    }
+}
+
+#ifdef CMS_POOL_STORAGE_MMAP_SUPPORTED
+
+// One anonymous mapping, reserved by the first test and kept for the
+// process. The kernel commits its pages as QF's pool init first touches
+// them, so neither Setup() nor Teardown() costs in proportion to the
+// pool sizes: Release() only marks the used pages as reclaimable, which
+// the next test reuses without faulting while memory is plentiful.
+static uint8_t* l_region   = nullptr;
+static size_t l_regionUsed = 0;
+
+static void Reserve()
+{
+    void* region = mmap(nullptr, CMS_POOL_STORAGE_RESERVE_BYTES,
+                        PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    Require(region != MAP_FAILED,
+            "unable to reserve CMS_POOL_STORAGE_RESERVE_BYTES of address "
+            "space, lower CMS_POOL_STORAGE_RESERVE_BYTES");
+    l_region = static_cast<uint8_t*>(region);
+
+#if defined(CMS_POOL_STORAGE_HUGE_PAGES) && defined(MADV_HUGEPAGE)
+    // transparent huge pages: fewer faults and TLB misses for large
+    // pools, falling back to small pages when none are available.
+    (void)madvise(region, CMS_POOL_STORAGE_RESERVE_BYTES, MADV_HUGEPAGE);
+#endif
+}
+
+uint8_t* Acquire(size_t bytes)
+{
+    if (l_region == nullptr) {
+        Reserve();
+    }
+
+    const size_t aligned = AlignUp(bytes);
+    Require(aligned <= CMS_POOL_STORAGE_RESERVE_BYTES - l_regionUsed,
+            "event pools exceed CMS_POOL_STORAGE_RESERVE_BYTES, "
+            "define it larger");
+
+    uint8_t* storage = &l_region[l_regionUsed];
+    l_regionUsed += aligned;
+    return storage;
+}
+
+void Release()
+{
+    if (l_regionUsed == 0U) {
+        return;
+    }
+
+#ifdef MADV_FREE
+    (void)madvise(l_region, l_regionUsed, MADV_FREE);
+#else
+    (void)madvise(l_region, l_regionUsed, MADV_DONTNEED);
+#endif
+    l_regionUsed = 0;
+}
+
+#else   // CMS_POOL_STORAGE_MMAP_SUPPORTED
+
+// without mmap, one heap block per pool, as storage was before
+static constexpr size_t MAX_BLOCKS = 16U;
+static void* l_blocks[MAX_BLOCKS];
+static size_t l_blockCount = 0;
+
+uint8_t* Acquire(size_t bytes)
+{
+    Require(l_blockCount < MAX_BLOCKS, "too many event pools");
+    void* block = std::malloc(AlignUp(bytes));
+    Require(block != nullptr, "out of memory for event pool storage");
+    l_blocks[l_blockCount++] = block;
+    return static_cast<uint8_t*>(block);
+}
+
+void Release()
+{
+    for (size_t i = 0; i < l_blockCount; ++i) {
+        std::free(l_blocks[i]);
+    }
+    l_blockCount = 0;
+}
+
+#endif   // CMS_POOL_STORAGE_MMAP_SUPPORTED
+
+}   // namespace pool_storage
+}   // namespace test
+}   // namespace cms
@@ -0,0 +1,52 @@
+/// @brief qf_ctrl internal event pool storage, reused across tests.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_POOL_STORAGE_HPP
+#define CMS_CPPUTEST_QF_POOL_STORAGE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+/// Address space reserved, once, for the event pools of one test.
+/// Only the pages a test touches are committed.
+#ifndef CMS_POOL_STORAGE_RESERVE_BYTES
+#define CMS_POOL_STORAGE_RESERVE_BYTES (256U * 1024U * 1024U)
+#endif
+
+namespace cms {
+namespace test {
+namespace pool_storage {
+
+// 'bytes' of event pool storage, cache line aligned, with undefined
+// contents, valid until Release().
+uint8_t* Acquire(size_t bytes);
+
+// give back all storage acquired since the last Release(), keeping the
+// address space for the next test.
+void Release();
+
+}   // namespace pool_storage
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_POOL_STORAGE_HPP
@@ -0,0 +1,270 @@
+/// @brief RAM footprint report for the QF configuration under test.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_ram.hpp"
+#include "cms_cpputest_qf_ram_hooks.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include "CppUTest/TestHarness.h"
+
+namespace cms {
+namespace test {
+namespace ram {
+
+namespace {
+
+struct DeclaredSize {
+    QP::QActive const* ao;
+    size_t size;
+};
+
+constexpr size_t MAX_DECLARED = 2U * QF_MAX_ACTIVE;
+
+std::array<DeclaredSize, MAX_DECLARED> l_declared;
+size_t l_declaredCount = 0;
+
+// test records outlive the tests, so are allocated with malloc, out of
+// sight of the cpputest leak detector.
+struct TestRecord {
+    char group[64];
+    char name[128];
+    Footprint footprint;
+};
+
+TestRecord* l_records = nullptr;
+size_t l_recordCount  = 0;
+size_t l_recordLimit  = 0;
+size_t l_tests        = 0;   // including those beyond the records
+TestRecord l_largest  = {};
+
+bool FindDeclaredSize(QP::QActive const* ao, size_t* size)
+{
+    for (size_t i = 0; i < l_declaredCount; ++i) {
+        if (l_declared[i].ao == ao) {
+            *size = l_declared[i].size;
+            return true;
+        }
+    }
+    return false;
+}
+
+QP::QActive* ActiveObjectAt(std::uint_fast8_t prio)
+{
+#if QP_VERSION > 800
+    return QP::QActive::fromRegistry(prio);
+#else
+    return QP::QActive::registry_[prio];
+#endif
+}
+
+void NameRecord(TestRecord* record)
+{
+    const UtestShell* current = UtestShell::getCurrent();
+    std::snprintf(record->group, sizeof(record->group), "%s",
+                  (current != nullptr) ? current->getGroup().asCharString() : "");
+    std::snprintf(record->name, sizeof(record->name), "%s",
+                  (current != nullptr) ? current->getName().asCharString() : "");
+}
+
+void AppendRecord(const Footprint& footprint)
+{
+    ++l_tests;
+    if ((l_tests == 1U) || (footprint.Total() > l_largest.footprint.Total())) {
+        NameRecord(&l_largest);
+        l_largest.footprint = footprint;
+    }
+
+    if (l_recordCount == CMS_RAM_MAX_TEST_RECORDS) {
+        return;
+    }
+
+    if (l_recordCount == l_recordLimit) {
+        const size_t limit = (l_recordLimit == 0U) ? 64U : 2U * l_recordLimit;
+        auto records       = static_cast<TestRecord*>(
+          std::realloc(l_records, limit * sizeof(TestRecord)));
+        if (records == nullptr) {
+            return;
+        }
+        l_records     = records;
+        l_recordLimit = limit;
+    }
+
+    TestRecord& record = l_records[l_recordCount++];
+    NameRecord(&record);
+    record.footprint = footprint;
+}
+
+const TestRecord* LargestRecord()
+{
+    return (l_tests != 0U) ? &l_largest : nullptr;
+}
+
+void PrintText(std::FILE* out, const char* label, const Footprint& fp)
+{
+    std::fprintf(out,
+                 "%s: total %zu pools %zu subscribers %zu queues %zu "
+                 "active objects %zu (%zu, %zu undeclared) framework %zu\n",
+                 label, fp.Total(), fp.poolBytes, fp.subscriberBytes,
+                 fp.queueBytes, fp.activeObjectBytes, fp.activeObjects,
+                 fp.undeclaredActiveObjects, fp.frameworkBytes);
+}
+
+// test group and names are C++ identifiers, but escape them regardless
+void PrintJsonString(std::FILE* out, const char* text)
+{
+    std::fputc('"', out);
+    for (const char* c = text; *c != '\0'; ++c) {
+        if ((*c == '"') || (*c == '\\')) {
+            std::fputc('\\', out);
+        }
+        if (static_cast<unsigned char>(*c) >= 0x20U) {
+            std::fputc(*c, out);
+        }
+    }
+    std::fputc('"', out);
+}
+
+void PrintJsonRecord(std::FILE* out, const TestRecord& record)
+{
+    const Footprint& fp = record.footprint;
+    std::fprintf(out, "{\"group\": ");
+    PrintJsonString(out, record.group);
+    std::fprintf(out, ", \"name\": ");
+    PrintJsonString(out, record.name);
+    std::fprintf(out,
+                 ", \"total\": %zu, \"pools\": %zu, \"subscribers\": %zu, "
+                 "\"queues\": %zu, \"activeObjectBytes\": %zu, "
+                 "\"activeObjects\": %zu, \"undeclaredActiveObjects\": %zu, "
+                 "\"framework\": %zu}",
+                 fp.Total(), fp.poolBytes, fp.subscriberBytes, fp.queueBytes,
+                 fp.activeObjectBytes, fp.activeObjects,
+                 fp.undeclaredActiveObjects, fp.frameworkBytes);
+}
+
+}   // namespace
+
+void DeclareActiveObjectSize(QP::QActive const* ao, size_t size)
+{
+    assert(ao != nullptr);
+
+    for (size_t i = 0; i < l_declaredCount; ++i) {
+        if (l_declared[i].ao == ao) {
+            l_declared[i].size = size;
+            return;
+        }
+    }
+
+    assert(l_declaredCount < l_declared.size());
+    l_declared[l_declaredCount++] = DeclaredSize {ao, size};
+}
+
+Footprint Measure()
+{
+    Footprint footprint {};
+    qf_ctrl::MeasureQfRam(&footprint);
+
+    for (std::uint_fast8_t prio = 1U; prio <= QF_MAX_ACTIVE; ++prio) {
+        const std::uint_fast16_t queueLength = QP::GetQueueLength(prio);
+        QP::QActive const* ao                = ActiveObjectAt(prio);
+        if ((queueLength == 0U) || (ao == nullptr)) {
+            continue;
+        }
+
+        ++footprint.activeObjects;
+        footprint.queueBytes += queueLength * sizeof(QP::QEvt const*);
+
+        size_t size = 0;
+        if (FindDeclaredSize(ao, &size)) {
+            footprint.activeObjectBytes += size;
+        }
+        else {
+            ++footprint.undeclaredActiveObjects;
+        }
+    }
+
+    return footprint;
+}
+
+void Reset()
+{
+    std::free(l_records);
+    l_records     = nullptr;
+    l_recordCount = 0;
+    l_recordLimit = 0;
+    l_tests       = 0;
+}
+
+void OnTeardown()
+{
+    AppendRecord(Measure());
+    l_declaredCount = 0;
+}
+
+void ReportText(std::FILE* out)
+{
+    assert(out != nullptr);
+
+    std::array<char, sizeof(TestRecord::group) + sizeof(TestRecord::name)> label {};
+    for (size_t i = 0; i < l_recordCount; ++i) {
+        std::snprintf(label.data(), label.size(), "%s.%s", l_records[i].group,
+                      l_records[i].name);
+        PrintText(out, label.data(), l_records[i].footprint);
+    }
+
+    const TestRecord* largest = LargestRecord();
+    if (largest != nullptr) {
+        std::snprintf(label.data(), label.size(),
+                      "suite largest of %zu tests (%s.%s)", l_tests,
+                      largest->group, largest->name);
+        PrintText(out, label.data(), largest->footprint);
+    }
+}
+
+void ReportJson(std::FILE* out)
+{
+    assert(out != nullptr);
+
+    std::fprintf(out, "{\n  \"tests\": [");
+    for (size_t i = 0; i < l_recordCount; ++i) {
+        std::fprintf(out, "%s\n    ", (i == 0U) ? "" : ",");
+        PrintJsonRecord(out, l_records[i]);
+    }
+    std::fprintf(out, "\n  ],\n  \"suite\": {\"tests\": %zu, \"largest\": ",
+                 l_tests);
+
+    const TestRecord* largest = LargestRecord();
+    if (largest != nullptr) {
+        PrintJsonRecord(out, *largest);
+    }
+    else {
+        std::fprintf(out, "null");
+    }
+    std::fprintf(out, "}\n}\n");
+}
+
+}   // namespace ram
+}   // namespace test
+}   // namespace cms
@@ -0,0 +1,50 @@
+/// @brief qf_ctrl internal interface to the RAM footprint report.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_QF_RAM_HOOKS_HPP
+#define CMS_CPPUTEST_QF_RAM_HOOKS_HPP
+
+#include "cms_cpputest_qf_ram.hpp"
+
+namespace cms {
+namespace test {
+
+namespace qf_ctrl {
+
+// fill the parts of 'footprint' owned by qf_ctrl: the pools, the
+// subscriber lists and QF's own storage.
+void MeasureQfRam(ram::Footprint* footprint);
+
+}   // namespace qf_ctrl
+
+namespace ram {
+
+// record the ending test's footprint and forget its declarations
+void OnTeardown();
+
+}   // namespace ram
+
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_QF_RAM_HOOKS_HPP
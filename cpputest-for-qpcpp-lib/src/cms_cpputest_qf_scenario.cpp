@@ -0,0 +1,660 @@
+/// @brief Scenario runner applying text scenario files through qf_ctrl.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_scenario.hpp"
+#include "cmsQAssertMockSupport.hpp"
+#include "cmsTestPublishedEventRecorder.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CMS_SCENARIO_MMAP_SUPPORTED
+#endif
+
+namespace cms {
+namespace test {
+namespace scenario {
+
+namespace {
+
+struct ActiveObjectEntry {
+    const char* name;
+    ActiveObjectFactory create;
+    ActiveObjectDestroyer destroy;
+};
+
+struct SignalEntry {
+    const char* name;
+    enum_t sig;
+};
+
+std::array<ActiveObjectEntry, MAX_ACTIVE_OBJECTS> l_activeObjects;
+size_t l_activeObjectCount = 0;
+
+std::array<SignalEntry, MAX_SIGNALS> l_signals;
+size_t l_signalCount = 0;
+
+enum_t l_maxPubSubSignalValue = QP::Q_USER_SIG;
+uint32_t l_ticksPerSecond     = 100;
+
+constexpr size_t MAX_REASON_LENGTH = 160;
+
+const ActiveObjectEntry* FindActiveObject(std::string_view name)
+{
+    for (size_t i = 0; i < l_activeObjectCount; ++i) {
+        if (name == l_activeObjects[i].name) {
+            return &l_activeObjects[i];
+        }
+    }
+    return nullptr;
+}
+
+const SignalEntry* FindSignal(std::string_view name)
+{
+    for (size_t i = 0; i < l_signalCount; ++i) {
+        if (name == l_signals[i].name) {
+            return &l_signals[i];
+        }
+    }
+    return nullptr;
+}
+
+const char* SignalName(enum_t sig)
+{
+    for (size_t i = 0; i < l_signalCount; ++i) {
+        if (l_signals[i].sig == sig) {
+            return l_signals[i].name;
+        }
+    }
+    return "(unregistered)";
+}
+
+bool IsBlank(char c)
+{
+    return (c == ' ') || (c == '\t') || (c == '\r');
+}
+
+std::string_view Trim(std::string_view text)
+{
+    while (!text.empty() && IsBlank(text.front())) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && IsBlank(text.back())) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// remove and return the first whitespace delimited token of 'text'
+std::string_view NextToken(std::string_view* text)
+{
+    *text       = Trim(*text);
+    size_t size = 0;
+    while ((size < text->size()) && !IsBlank((*text)[size])) {
+        ++size;
+    }
+    const std::string_view token = text->substr(0, size);
+    text->remove_prefix(size);
+    *text = Trim(*text);
+    return token;
+}
+
+// "250", "250ms" or "5s"
+bool ParseTime(std::string_view text, std::chrono::milliseconds* time)
+{
+    uint64_t value = 0;
+    size_t digits  = 0;
+    while ((digits < text.size()) && (text[digits] >= '0') &&
+           (text[digits] <= '9')) {
+        value = value * 10U + static_cast<uint64_t>(text[digits] - '0');
+        ++digits;
+    }
+
+    const std::string_view unit = text.substr(digits);
+    if ((digits == 0) || ((unit != "") && (unit != "ms") && (unit != "s"))) {
+        return false;
+    }
+
+    if (unit == "s") {
+        value *= 1000U;
+    }
+    *time = std::chrono::milliseconds(static_cast<int64_t>(value));
+    return true;
+}
+
+// iterates the lines of a text without copying them
+class LineReader {
+public:
+    LineReader(const char* text, size_t length) :
+        m_text(text, length), m_lineNumber(0)
+    {
+    }
+
+    bool next(std::string_view* line)
+    {
+        if (m_text.empty()) {
+            return false;
+        }
+
+        size_t end = m_text.find('\n');
+        if (end == std::string_view::npos) {
+            end = m_text.size();
+        }
+        *line  = m_text.substr(0, end);
+        m_text.remove_prefix(std::min(end + 1, m_text.size()));
+        ++m_lineNumber;
+        return true;
+    }
+
+    size_t lineNumber() const { return m_lineNumber; }
+
+private:
+    std::string_view m_text;
+    size_t m_lineNumber;
+};
+
+// one scenario, applied step by step between Setup() and Teardown()
+class ScenarioRun {
+public:
+    ScenarioRun() : m_started(), m_startedCount(0), m_recorder(nullptr),
+        m_reason()
+    {
+        qf_ctrl::Setup(l_maxPubSubSignalValue, l_ticksPerSecond, {},
+                       qf_ctrl::MemPoolTeardownOption::IGNORE);
+        m_recorder = PublishedEventRecorder::CreatePublishedEventRecorder(
+          qf_ctrl::RECORDER_PRIORITY, QP::Q_USER_SIG, l_maxPubSubSignalValue);
+    }
+
+    ScenarioRun(const ScenarioRun&)            = delete;
+    ScenarioRun& operator=(const ScenarioRun&) = delete;
+
+    /// \return false, with reason(), if the step failed.
+    bool apply(std::string_view keyword, std::string_view args)
+    {
+        if (keyword == "start") {
+            return start(args);
+        }
+        if (keyword == "post") {
+            return post(args);
+        }
+        if (keyword == "publish") {
+            return publish(args);
+        }
+        if (keyword == "advance") {
+            return advance(args);
+        }
+        if (keyword == "expect") {
+            return expect(args);
+        }
+        if (keyword == "expect-none") {
+            return expectNone();
+        }
+        return fail("unknown step '%.*s'", keyword);
+    }
+
+    /// Release the scenario's active objects and Teardown() QF.
+    /// \return false, with reason(), if pool events leaked.
+    bool finish(bool passed)
+    {
+        qf_ctrl::ProcessEvents();
+        delete m_recorder;
+        m_recorder = nullptr;
+
+        const size_t leaked = qf_ctrl::PoolEventsInUse();
+        qf_ctrl::Teardown();
+
+        while (m_startedCount > 0) {
+            --m_startedCount;
+            m_started[m_startedCount].entry->destroy(
+              m_started[m_startedCount].ao);
+        }
+
+        if (passed && (leaked != 0U)) {
+            std::snprintf(m_reason.data(), m_reason.size(),
+                          "%zu pool event(s) leaked", leaked);
+            return false;
+        }
+        return passed;
+    }
+
+    const char* reason() const { return m_reason.data(); }
+
+private:
+    struct Started {
+        const ActiveObjectEntry* entry;
+        QP::QActive* ao;
+    };
+
+    bool fail(const char* format, std::string_view name)
+    {
+        std::snprintf(m_reason.data(), m_reason.size(), format,
+                      static_cast<int>(name.size()), name.data());
+        return false;
+    }
+
+    bool findSignal(std::string_view name, enum_t* sig)
+    {
+        const SignalEntry* signal = FindSignal(name);
+        if (signal == nullptr) {
+            return fail("unknown signal '%.*s'", name);
+        }
+        *sig = signal->sig;
+        return true;
+    }
+
+    bool findPubSubSignal(std::string_view name, enum_t* sig)
+    {
+        if (!findSignal(name, sig)) {
+            return false;
+        }
+        if (*sig >= l_maxPubSubSignalValue) {
+            return fail("'%.*s' is not a pub/sub signal", name);
+        }
+        return true;
+    }
+
+    QP::QActive* findStarted(std::string_view name)
+    {
+        for (size_t i = 0; i < m_startedCount; ++i) {
+            if (name == m_started[i].entry->name) {
+                return m_started[i].ao;
+            }
+        }
+        fail("active object '%.*s' is not started", name);
+        return nullptr;
+    }
+
+    bool start(std::string_view args)
+    {
+        const std::string_view name    = NextToken(&args);
+        const ActiveObjectEntry* entry = FindActiveObject(name);
+        if (entry == nullptr) {
+            return fail("unknown active object '%.*s'", name);
+        }
+        if (m_startedCount == m_started.size()) {
+            return fail("too many active objects at '%.*s'", name);
+        }
+
+        m_started[m_startedCount] = Started {entry, entry->create()};
+        ++m_startedCount;
+        qf_ctrl::ProcessEvents();
+        return true;
+    }
+
+    bool post(std::string_view args)
+    {
+        QP::QActive* dest = findStarted(NextToken(&args));
+        enum_t sig        = 0;
+        if ((dest == nullptr) || !findSignal(NextToken(&args), &sig)) {
+            return false;
+        }
+
+        qf_ctrl::PostAndProcess(Q_NEW(QP::QEvt, sig), dest);
+        return true;
+    }
+
+    bool publish(std::string_view args)
+    {
+        enum_t sig = 0;
+        if (!findPubSubSignal(NextToken(&args), &sig)) {
+            return false;
+        }
+
+        qf_ctrl::PublishAndProcess(sig, m_recorder);
+        return true;
+    }
+
+    bool advance(std::string_view args)
+    {
+        const std::string_view token = NextToken(&args);
+        std::chrono::milliseconds time(0);
+        if (!ParseTime(token, &time)) {
+            return fail("invalid time '%.*s'", token);
+        }
+
+        qf_ctrl::MoveTimeForward(time);
+        return true;
+    }
+
+    bool expect(std::string_view args)
+    {
+        const std::string_view name = NextToken(&args);
+        enum_t sig                  = 0;
+        if (!findPubSubSignal(name, &sig)) {
+            return false;
+        }
+
+        const auto e = m_recorder->getRecordedEvent<QP::QEvt>();
+        if (e == nullptr) {
+            return fail("expected '%.*s', nothing was published", name);
+        }
+        if (e->sig != sig) {
+            std::snprintf(m_reason.data(), m_reason.size(),
+                          "expected '%.*s', %s (%d) was published",
+                          static_cast<int>(name.size()), name.data(),
+                          SignalName(e->sig), static_cast<int>(e->sig));
+            return false;
+        }
+        return true;
+    }
+
+    bool expectNone()
+    {
+        const auto e = m_recorder->getRecordedEvent<QP::QEvt>();
+        if (e != nullptr) {
+            std::snprintf(m_reason.data(), m_reason.size(),
+                          "expected nothing, %s (%d) was published",
+                          SignalName(e->sig), static_cast<int>(e->sig));
+            return false;
+        }
+        return true;
+    }
+
+    std::array<Started, MAX_ACTIVE_OBJECTS> m_started;
+    size_t m_startedCount;
+    PublishedEventRecorder* m_recorder;
+    std::array<char, MAX_REASON_LENGTH> m_reason;
+};
+
+void LogFailure(FILE* log, const char* source, size_t lineNumber,
+                std::string_view scenarioName, const char* reason)
+{
+    if (log != nullptr) {
+        std::fprintf(log, "%s:%zu: %.*s: %s\n", source, lineNumber,
+                     static_cast<int>(scenarioName.size()),
+                     scenarioName.data(), reason);
+    }
+}
+
+// read only view of a file, memory-mapped where supported
+class MappedFile {
+public:
+    explicit MappedFile(const char* path) :
+        m_data(nullptr), m_size(0), m_loaded(false), m_mapped(false)
+    {
+#ifdef CMS_SCENARIO_MMAP_SUPPORTED
+        const int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return;
+        }
+
+        struct stat status {};
+        if (fstat(fd, &status) == 0) {
+            m_size   = static_cast<size_t>(status.st_size);
+            m_loaded = true;
+            if (m_size > 0) {
+                void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                m_loaded   = (data != MAP_FAILED);
+                if (m_loaded) {
+                    m_data   = data;
+                    m_mapped = true;
+                    static_cast<void>(madvise(data, m_size, MADV_SEQUENTIAL));
+                }
+            }
+        }
+        close(fd);
+#else
+        FILE* file = std::fopen(path, "rb");
+        if (file == nullptr) {
+            return;
+        }
+
+        if ((std::fseek(file, 0, SEEK_END) == 0)) {
+            const long size = std::ftell(file);
+            if ((size >= 0) && (std::fseek(file, 0, SEEK_SET) == 0)) {
+                m_size = static_cast<size_t>(size);
+                m_data = std::malloc(std::max<size_t>(m_size, 1U));
+                m_loaded = (m_data != nullptr) &&
+                           (std::fread(m_data, 1, m_size, file) == m_size);
+            }
+        }
+        std::fclose(file);
+#endif
+    }
+
+    ~MappedFile()
+    {
+#ifdef CMS_SCENARIO_MMAP_SUPPORTED
+        if (m_mapped) {
+            munmap(m_data, m_size);
+        }
+#else
+        std::free(m_data);
+#endif
+    }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool isLoaded() const { return m_loaded; }
+    const char* data() const { return static_cast<const char*>(m_data); }
+    size_t size() const { return m_size; }
+
+private:
+    void* m_data;
+    size_t m_size;
+    bool m_loaded;
+    bool m_mapped;
+};
+
+void Accumulate(RunSummary* total, const RunSummary& summary)
+{
+    total->files += summary.files;
+    total->unreadableFiles += summary.unreadableFiles;
+    total->scenarios += summary.scenarios;
+    total->passed += summary.passed;
+    total->failed += summary.failed;
+    total->steps += summary.steps;
+    total->seconds += summary.seconds;
+}
+
+}   // namespace
+
+void Configure(enum_t maxPubSubSignalValue, uint32_t ticksPerSecond)
+{
+    assert(maxPubSubSignalValue >= QP::Q_USER_SIG);
+    assert(ticksPerSecond != 0);
+
+    l_maxPubSubSignalValue = maxPubSubSignalValue;
+    l_ticksPerSecond       = ticksPerSecond;
+}
+
+bool RegisterActiveObject(const char* name, ActiveObjectFactory create,
+                          ActiveObjectDestroyer destroy)
+{
+    assert(name != nullptr);
+    assert(create != nullptr);
+    assert(destroy != nullptr);
+
+    if ((l_activeObjectCount == l_activeObjects.size()) ||
+        (FindActiveObject(name) != nullptr)) {
+        return false;
+    }
+
+    l_activeObjects[l_activeObjectCount] = ActiveObjectEntry {name, create, destroy};
+    ++l_activeObjectCount;
+    return true;
+}
+
+bool RegisterSignal(const char* name, enum_t sig)
+{
+    assert(name != nullptr);
+
+    if ((l_signalCount == l_signals.size()) || (FindSignal(name) != nullptr)) {
+        return false;
+    }
+
+    l_signals[l_signalCount] = SignalEntry {name, sig};
+    ++l_signalCount;
+    return true;
+}
+
+void ClearRegistry()
+{
+    l_activeObjectCount = 0;
+    l_signalCount       = 0;
+}
+
+RunSummary RunText(const char* text, size_t length, const char* source,
+                   FILE* log)
+{
+    assert((text != nullptr) || (length == 0));
+    assert(source != nullptr);
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    RunSummary summary {1, 0, 0, 0, 0, 0, 0.0};
+    LineReader reader(text, length);
+    std::string_view line;
+    std::string_view scenarioName;
+    std::optional<ScenarioRun> run;
+    bool passed = false;
+
+    while (reader.next(&line)) {
+        std::string_view args = line;
+        const std::string_view keyword = NextToken(&args);
+        if (keyword.empty() || (keyword.front() == '#')) {
+            continue;
+        }
+
+        if (!run) {
+            if (keyword != "scenario") {
+                ++summary.scenarios;
+                ++summary.failed;
+                LogFailure(log, source, reader.lineNumber(), keyword,
+                           "expected 'scenario <name>'");
+                continue;
+            }
+            scenarioName = args;
+            run.emplace();
+            passed = true;
+            ++summary.scenarios;
+        }
+        else if (keyword == "end") {
+            passed = run->finish(passed);
+            if (!passed) {
+                LogFailure(log, source, reader.lineNumber(), scenarioName,
+                           run->reason());
+            }
+            run.reset();
+            if (passed) {
+                ++summary.passed;
+            }
+            else {
+                ++summary.failed;
+            }
+        }
+        else if (passed) {
+            // after a failure, skip the remaining steps
+            ++summary.steps;
+            passed = run->apply(keyword, args);
+            if (!passed) {
+                LogFailure(log, source, reader.lineNumber(), scenarioName,
+                           run->reason());
+            }
+        }
+    }
+
+    if (run) {
+        static_cast<void>(run->finish(passed));
+        run.reset();
+        ++summary.failed;
+        LogFailure(log, source, reader.lineNumber(), scenarioName,
+                   "missing 'end'");
+    }
+
+    summary.seconds = std::chrono::duration<double>(
+                        std::chrono::steady_clock::now() - startTime)
+                        .count();
+    return summary;
+}
+
+RunSummary RunFile(const char* path, FILE* log)
+{
+    assert(path != nullptr);
+
+    MappedFile file(path);
+    if (!file.isLoaded()) {
+        if (log != nullptr) {
+            std::fprintf(log, "%s: unable to read\n", path);
+        }
+        return RunSummary {1, 1, 0, 0, 0, 0, 0.0};
+    }
+
+    return RunText(file.data(), file.size(), path, log);
+}
+
+void Report(const RunSummary& summary, FILE* out)
+{
+    assert(out != nullptr);
+
+    std::fprintf(out,
+                 "scenarios: %zu passed: %zu failed: %zu steps: %zu in %.1f ms",
+                 summary.scenarios, summary.passed, summary.failed,
+                 summary.steps, summary.seconds * 1000.0);
+    if (summary.seconds > 0.0) {
+        std::fprintf(out, " (%.0f scenarios/s)",
+                     static_cast<double>(summary.scenarios) / summary.seconds);
+    }
+    if (summary.unreadableFiles != 0U) {
+        std::fprintf(out, " unreadable files: %zu", summary.unreadableFiles);
+    }
+    std::fprintf(out, "\n");
+}
+
+int RunMain(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <scenario file>...\n",
+                     (argc > 0) ? argv[0] : "scenario-runner");
+        return EXIT_FAILURE;
+    }
+
+    QAssertAbortEnable();
+
+    RunSummary total {0, 0, 0, 0, 0, 0, 0.0};
+    for (int i = 1; i < argc; ++i) {
+        Accumulate(&total, RunFile(argv[i], stdout));
+    }
+    Report(total, stdout);
+
+    return ((total.failed == 0U) && (total.unreadableFiles == 0U))
+             ? EXIT_SUCCESS
+             : EXIT_FAILURE;
+}
+
+}   // namespace scenario
+}   // namespace test
+}   // namespace cms
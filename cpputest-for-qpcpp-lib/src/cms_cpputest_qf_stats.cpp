@@ -0,0 +1,99 @@
+/// @brief Runtime statistics of the fake QF port, since qf_ctrl::Setup().
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_stats.hpp"
+
+namespace cms {
+namespace test {
+namespace qf_ctrl {
+
+#ifdef CMS_ENABLE_QF_STATS
+
+static QfStats l_stats = {};
+
+QfStats GetStats()
+{
+    return l_stats;
+}
+
+void ResetStats()
+{
+    l_stats = {};
+}
+
+void StatsOnDispatch(std::uint_fast8_t prio)
+{
+    ++l_stats.dispatched[prio];
+}
+
+void StatsOnPublish()
+{
+    ++l_stats.publishes;
+}
+
+void StatsOnDelivery()
+{
+    ++l_stats.deliveries;
+}
+
+void StatsOnPost()
+{
+    ++l_stats.posts;
+}
+
+void StatsOnPoolGet(std::uint_fast8_t poolNum)
+{
+    ++l_stats.allocations[poolNum - 1U];
+}
+
+void StatsOnPoolPut(std::uint_fast8_t poolNum)
+{
+    ++l_stats.frees[poolNum - 1U];
+}
+
+void StatsOnTick()
+{
+    ++l_stats.ticks;
+}
+
+void StatsOnSchedulerPass()
+{
+    ++l_stats.schedulerPasses;
+}
+
+#else   // CMS_ENABLE_QF_STATS
+
+QfStats GetStats()
+{
+    return {};
+}
+
+void ResetStats()
+{
+}
+
+#endif   // CMS_ENABLE_QF_STATS
+
+}   // namespace qf_ctrl
+}   // namespace test
+}   // namespace cms
@@ -0,0 +1,224 @@
+/// @brief (state handler, signal) dispatch coverage for QP state machines.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_state_coverage.hpp"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace cms {
+namespace test {
+namespace coverage {
+
+namespace {
+
+constexpr size_t MAX_STATES  = CMS_STATE_COVERAGE_MAX_STATES;
+constexpr size_t MAX_SIGNALS = CMS_STATE_COVERAGE_MAX_SIGNALS;
+
+// open addressing index from state handler to slot, kept at most half full
+constexpr size_t INDEX_SIZE = MAX_STATES * 2U;
+static_assert((INDEX_SIZE & (INDEX_SIZE - 1U)) == 0U,
+              "CMS_STATE_COVERAGE_MAX_STATES must be a power of two");
+constexpr uint16_t NO_SLOT = 0xFFFFU;
+static_assert(MAX_STATES < NO_SLOT, "too many coverage states");
+
+struct StateSlot {
+    QP::QStateHandler state;
+    QP::QAsm const* machine;   // first instance seen in this state
+    const char* name;
+};
+
+#ifdef CMS_STATE_COVERAGE_LIBFUZZER_COUNTERS
+__attribute__((section("__libfuzzer_extra_counters")))
+#endif
+uint8_t l_counters[MAX_STATES * MAX_SIGNALS];
+
+std::array<StateSlot, MAX_STATES> l_slots {};
+size_t l_slotCount = 0;
+std::array<uint16_t, INDEX_SIZE> l_index = []() {
+    std::array<uint16_t, INDEX_SIZE> index {};
+    index.fill(NO_SLOT);
+    return index;
+}();
+size_t l_dropped = 0;
+
+uintptr_t HandlerBits(QP::QStateHandler state)
+{
+    static_assert(sizeof(state) == sizeof(uintptr_t),
+                  "unexpected function pointer size");
+    uintptr_t bits = 0;
+    std::memcpy(&bits, &state, sizeof(bits));
+    return bits;
+}
+
+// \return the slot for 'state', adding it if 'add' and room remains.
+uint16_t FindSlot(QP::QStateHandler state, bool add)
+{
+    const uintptr_t bits = HandlerBits(state);
+    size_t i = static_cast<size_t>((bits >> 2U) * 0x9E3779B97F4A7C15ULL) &
+               (INDEX_SIZE - 1U);
+    for (;;) {
+        const uint16_t slot = l_index[i];
+        if (slot == NO_SLOT) {
+            break;
+        }
+        if (l_slots[slot].state == state) {
+            return slot;
+        }
+        i = (i + 1U) & (INDEX_SIZE - 1U);
+    }
+
+    if (!add || (l_slotCount >= MAX_STATES)) {
+        return NO_SLOT;
+    }
+
+    const auto slot = static_cast<uint16_t>(l_slotCount++);
+    l_slots[slot]   = StateSlot {state, nullptr, nullptr};
+    l_index[i]      = slot;
+    return slot;
+}
+
+}   // namespace
+
+void Record(QP::QAsm const* machine, QP::QStateHandler state,
+            QP::QSignal sig)
+{
+    if (sig >= MAX_SIGNALS) {
+        ++l_dropped;
+        return;
+    }
+
+    const uint16_t slot = FindSlot(state, true);
+    if (slot == NO_SLOT) {
+        ++l_dropped;
+        return;
+    }
+
+    if (l_slots[slot].machine == nullptr) {
+        l_slots[slot].machine = machine;
+    }
+
+    uint8_t& counter = l_counters[slot * MAX_SIGNALS + sig];
+    if (counter != UINT8_MAX) {
+        ++counter;
+    }
+}
+
+void Reset()
+{
+    std::memset(l_counters, 0, sizeof(l_counters));
+    l_dropped = 0;
+}
+
+bool IsCovered(QP::QStateHandler state, enum_t sig)
+{
+    if ((sig < 0) || (static_cast<size_t>(sig) >= MAX_SIGNALS)) {
+        return false;
+    }
+
+    const uint16_t slot = FindSlot(state, false);
+    return (slot != NO_SLOT) &&
+           (l_counters[slot * MAX_SIGNALS + static_cast<size_t>(sig)] != 0U);
+}
+
+size_t CoveredPairs()
+{
+    return static_cast<size_t>(
+      std::count_if(std::begin(l_counters), std::end(l_counters),
+                    [](uint8_t counter) { return counter != 0U; }));
+}
+
+size_t Dropped()
+{
+    return l_dropped;
+}
+
+const uint8_t* Counters()
+{
+    return l_counters;
+}
+
+size_t CountersSize()
+{
+    return sizeof(l_counters);
+}
+
+void NameState(QP::QStateHandler state, const char* name)
+{
+    // a named state may not have been dispatched to yet
+    const uint16_t slot = FindSlot(state, true);
+    if (slot != NO_SLOT) {
+        l_slots[slot].name = name;
+    }
+}
+
+void Report(std::FILE* out)
+{
+    std::array<bool, MAX_STATES> reported {};
+    for (size_t first = 0; first < l_slotCount; ++first) {
+        if (reported[first]) {
+            continue;
+        }
+
+        QP::QAsm const* machine = l_slots[first].machine;
+        if (machine != nullptr) {
+            std::fprintf(out, "state machine %p\n",
+                         static_cast<const void*>(machine));
+        }
+        else {
+            std::fprintf(out, "named states never dispatched to\n");
+        }
+
+        for (size_t slot = first; slot < l_slotCount; ++slot) {
+            if (reported[slot] || (l_slots[slot].machine != machine)) {
+                continue;
+            }
+            reported[slot] = true;
+
+            if (l_slots[slot].name != nullptr) {
+                std::fprintf(out, "  %s:", l_slots[slot].name);
+            }
+            else {
+                std::fprintf(out, "  state 0x%llx:",
+                             static_cast<unsigned long long>(
+                               HandlerBits(l_slots[slot].state)));
+            }
+
+            for (size_t sig = 0; sig < MAX_SIGNALS; ++sig) {
+                const uint8_t count = l_counters[slot * MAX_SIGNALS + sig];
+                if (count != 0U) {
+                    std::fprintf(out, " %zu(x%u)", sig,
+                                 static_cast<unsigned>(count));
+                }
+            }
+            std::fprintf(out, "\n");
+        }
+    }
+
+    std::fprintf(out, "covered pairs: %zu, dropped: %zu\n", CoveredPairs(),
+                 l_dropped);
+}
+
+}   // namespace coverage
+}   // namespace test
+}   // namespace cms
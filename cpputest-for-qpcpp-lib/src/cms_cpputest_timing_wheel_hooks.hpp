@@ -0,0 +1,46 @@
+/// @brief qf_ctrl internal interface to the WheelTimeEvt timing wheel.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_CPPUTEST_TIMING_WHEEL_HOOKS_HPP
+#define CMS_CPPUTEST_TIMING_WHEEL_HOOKS_HPP
+
+#include "cms_cpputest_qf_ctrl.hpp"
+
+namespace cms {
+namespace test {
+namespace qf_ctrl {
+
+// forget all armed WheelTimeEvt objects and restart the wheel at tick 0
+void TimingWheelReset();
+
+// advance the wheel one tick, posting each expiring WheelTimeEvt
+void TimingWheelTick();
+
+// the wheel's state, for Checkpoint() and Restore()
+MemoryRegion TimingWheelRegion();
+
+}   // namespace qf_ctrl
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_CPPUTEST_TIMING_WHEEL_HOOKS_HPP
@@ -0,0 +1,247 @@
+/// @brief Hierarchical timing wheel backing cms::WheelTimeEvt.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cmsWheelTimeEvt.hpp"
+#include "cms_cpputest_timing_wheel_hooks.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <cassert>
+#include <cstddef>
+
+namespace cms {
+
+namespace {
+
+constexpr unsigned SLOT_BITS = 6;
+constexpr size_t SLOTS       = size_t {1} << SLOT_BITS;
+constexpr uint64_t SLOT_MASK = SLOTS - 1U;
+constexpr size_t LEVELS      = 4;
+constexpr uint64_t TOP_MASK  = (uint64_t {1} << (LEVELS * SLOT_BITS)) - 1U;
+
+struct WheelState {
+    std::array<std::array<WheelTimeEvt*, SLOTS>, LEVELS> slots;
+    WheelTimeEvt* overflow;
+    uint64_t now;
+    uint32_t epoch;   // advanced by each reset, disowning armed time events
+};
+
+WheelState l_wheel = {};
+
+}   // namespace
+
+/// Four levels of 64 slots. Level L holds time events expiring within
+/// 64 slots of 64^L ticks, in the slot of their expiry, and is cascaded
+/// into the levels below as the current tick reaches that slot. Time
+/// events beyond the top level wait in an overflow list, revisited each
+/// time the top level wraps. A tick therefore visits only the expiring
+/// time events, plus those cascading down a level.
+class TimingWheel {
+public:
+    static void reset()
+    {
+        ++l_wheel.epoch;
+        l_wheel.now = 0;
+        for (auto& level : l_wheel.slots) {
+            level.fill(nullptr);
+        }
+        l_wheel.overflow = nullptr;
+    }
+
+    static void tick()
+    {
+        const uint64_t now = ++l_wheel.now;
+
+        // higher levels first, so a time event may cascade more than once
+        if ((now & TOP_MASK) == 0U) {
+            cascade(&l_wheel.overflow);
+        }
+        for (size_t level = LEVELS - 1U; level > 0U; --level) {
+            const unsigned shift = static_cast<unsigned>(level) * SLOT_BITS;
+            if ((now & ((uint64_t {1} << shift) - 1U)) == 0U) {
+                cascade(&l_wheel.slots[level][(now >> shift) & SLOT_MASK]);
+            }
+        }
+
+        WheelTimeEvt** slot = &l_wheel.slots[0][now & SLOT_MASK];
+        WheelTimeEvt* expiring = *slot;
+        *slot                  = nullptr;
+        while (expiring != nullptr) {
+            WheelTimeEvt* te = expiring;
+            expiring         = te->m_next;
+            assert(te->m_expiry == now);
+
+            te->m_slot = nullptr;
+            if (te->m_interval != 0U) {
+                te->m_expiry = now + te->m_interval;
+                insert(te);
+            }
+            te->m_act->POST(te, nullptr);
+        }
+    }
+
+    static void arm(WheelTimeEvt* te, uint32_t nTicks)
+    {
+        assert(nTicks != 0U);
+        te->m_expiry = l_wheel.now + nTicks;
+        te->m_epoch  = l_wheel.epoch;
+        insert(te);
+    }
+
+    static bool isArmed(const WheelTimeEvt* te)
+    {
+        return (te->m_slot != nullptr) && (te->m_epoch == l_wheel.epoch);
+    }
+
+    static void unlink(WheelTimeEvt* te)
+    {
+        if (te->m_prev != nullptr) {
+            te->m_prev->m_next = te->m_next;
+        }
+        else {
+            *te->m_slot = te->m_next;
+        }
+        if (te->m_next != nullptr) {
+            te->m_next->m_prev = te->m_prev;
+        }
+        te->m_slot = nullptr;
+    }
+
+    static uint64_t now() { return l_wheel.now; }
+
+    static test::qf_ctrl::MemoryRegion region()
+    {
+        return {static_cast<void*>(&l_wheel), sizeof(l_wheel)};
+    }
+
+private:
+    static void push(WheelTimeEvt** slot, WheelTimeEvt* te)
+    {
+        te->m_slot = slot;
+        te->m_prev = nullptr;
+        te->m_next = *slot;
+        if (*slot != nullptr) {
+            (*slot)->m_prev = te;
+        }
+        *slot = te;
+    }
+
+    static void insert(WheelTimeEvt* te)
+    {
+        assert(te->m_expiry >= l_wheel.now);
+
+        // the lowest level whose slots reach the expiry, comparing slot
+        // numbers rather than ticks so that no slot is passed over.
+        for (size_t level = 0; level < LEVELS; ++level) {
+            const unsigned shift = static_cast<unsigned>(level) * SLOT_BITS;
+            if (((te->m_expiry >> shift) - (l_wheel.now >> shift)) < SLOTS) {
+                push(&l_wheel.slots[level][(te->m_expiry >> shift) & SLOT_MASK],
+                     te);
+                return;
+            }
+        }
+        push(&l_wheel.overflow, te);
+    }
+
+    static void cascade(WheelTimeEvt** slot)
+    {
+        WheelTimeEvt* te = *slot;
+        *slot            = nullptr;
+        while (te != nullptr) {
+            WheelTimeEvt* next = te->m_next;
+            insert(te);
+            te = next;
+        }
+    }
+
+};
+
+WheelTimeEvt::WheelTimeEvt(QP::QActive* act, QP::QSignal sig,
+                           std::uint_fast8_t tickRate) noexcept :
+    QP::QEvt(sig), m_act(act), m_next(nullptr), m_prev(nullptr),
+    m_slot(nullptr), m_expiry(0), m_interval(0), m_epoch(0)
+{
+    static_cast<void>(tickRate);
+    assert(act != nullptr);
+    assert(tickRate == 0U);
+}
+
+WheelTimeEvt::~WheelTimeEvt()
+{
+    static_cast<void>(disarm());
+}
+
+void WheelTimeEvt::armX(std::uint32_t nTicks, std::uint32_t interval) noexcept
+{
+    assert(!isArmed());
+    m_interval = interval;
+    TimingWheel::arm(this, nTicks);
+}
+
+bool WheelTimeEvt::disarm() noexcept
+{
+    if (!isArmed()) {
+        return false;
+    }
+    TimingWheel::unlink(this);
+    return true;
+}
+
+bool WheelTimeEvt::rearm(std::uint32_t nTicks) noexcept
+{
+    const bool wasArmed = disarm();
+    TimingWheel::arm(this, nTicks);
+    return wasArmed;
+}
+
+bool WheelTimeEvt::isArmed() const noexcept
+{
+    return TimingWheel::isArmed(this);
+}
+
+std::uint32_t WheelTimeEvt::getCtr() const noexcept
+{
+    return isArmed() ? static_cast<std::uint32_t>(m_expiry - TimingWheel::now())
+                     : 0U;
+}
+
+namespace test {
+namespace qf_ctrl {
+
+void TimingWheelReset()
+{
+    TimingWheel::reset();
+}
+
+void TimingWheelTick()
+{
+    TimingWheel::tick();
+}
+
+MemoryRegion TimingWheelRegion()
+{
+    return TimingWheel::region();
+}
+
+}   // namespace qf_ctrl
+}   // namespace test
+}   // namespace cms
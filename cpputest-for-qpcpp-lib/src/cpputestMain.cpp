@@ -1,6 +1,58 @@
 #include "CppUTest/CommandLineTestRunner.h"
+#include "CppUTest/TestRegistry.h"
+#include <cstdio>
+#include <cstdlib>
+#include "cms_cpputest_qf_lifetime.hpp"
+#include "cms_cpputest_qf_metrics.hpp"
+#include "cms_cpputest_qf_ram.hpp"
+
+#ifdef CMS_ENABLE_STATE_COVERAGE
+#include "cms_cpputest_state_coverage.hpp"
+#endif
+
+// write a report to the file named by 'variable', if set
+static void WriteReport(const char* variable, void (*report)(std::FILE*))
+{
+    const char* reportPath = std::getenv(variable);
+    if (reportPath != nullptr) {
+        std::FILE* out = std::fopen(reportPath, "w");
+        if (out != nullptr) {
+            report(out);
+            std::fclose(out);
+        }
+    }
+}
 
 int main(int ac, char** av)
 {
-    return CommandLineTestRunner::RunAllTests(ac, av);
+    // measure each test's cost, if a report file was requested
+    cms::test::metrics::MetricsPlugin metricsPlugin;
+    if (std::getenv("CMS_TEST_METRICS_REPORT") != nullptr) {
+        TestRegistry::getCurrentRegistry()->installPlugin(&metricsPlugin);
+    }
+
+    // stamp every pool event of the suite, if a report file was requested
+    if (std::getenv("CMS_EVENT_LIFETIME_REPORT") != nullptr) {
+        cms::test::lifetime::Enable();
+    }
+
+    int result = CommandLineTestRunner::RunAllTests(ac, av);
+
+#ifdef CMS_ENABLE_STATE_COVERAGE
+    // export the suite's coverage matrix, if a report file was requested
+    WriteReport("CMS_STATE_COVERAGE_REPORT", &cms::test::coverage::Report);
+#endif
+
+    // export the per test and suite RAM footprints, if requested
+    WriteReport("CMS_RAM_REPORT", &cms::test::ram::ReportText);
+    WriteReport("CMS_RAM_REPORT_JSON", &cms::test::ram::ReportJson);
+
+    // export the event lifetime histograms, longest queued first
+    WriteReport("CMS_EVENT_LIFETIME_REPORT", &cms::test::lifetime::Report);
+
+    // export the per test cost metrics, most costly first
+    WriteReport("CMS_TEST_METRICS_REPORT", &cms::test::metrics::ReportJson);
+    TestRegistry::getCurrentRegistry()->resetPlugins();
+
+    return result;
 }
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include "qp_port.hpp"   // QF port
 #include "qp_pkg.hpp"    // QF package-scope interface
 #include "qsafe.h"       // QP embedded systems-friendly assertions
+#include "cms_cpputest_qf_stats.hpp"
+#include "cms_cpputest_state_coverage.hpp"
 #ifdef Q_SPY             // QS software tracing enabled?
     #error "Q_SPY not supported in the cpputest port"
 #else
@@ -22,11 +24,62 @@ Q_DEFINE_THIS_MODULE("cpputest_qf_port")
 
 /* Global objects ==========================================================*/
 QPSet cpputest_readySet_;   // ready set of active objects
+std::uint64_t cpputest_publishCount_ = 0U;
+bool cpputest_publishing_            = false;
+
+#ifndef CPPUTEST_MAX_DISPATCH_OBSERVERS
+#define CPPUTEST_MAX_DISPATCH_OBSERVERS 8U
+#endif
+
+static std::array<DispatchObserver const*, CPPUTEST_MAX_DISPATCH_OBSERVERS>
+  l_dispatchObservers;
+static std::size_t l_dispatchObserverCount = 0U;
+
+#ifndef CPPUTEST_MAX_POOL_OBSERVERS
+#define CPPUTEST_MAX_POOL_OBSERVERS 4U
+#endif
+
+static std::array<PoolObserver const*, CPPUTEST_MAX_POOL_OBSERVERS>
+  l_poolObservers;
+static std::size_t l_poolObserverCount = 0U;
+
+#ifndef CPPUTEST_MAX_TRAFFIC_TAPS
+#define CPPUTEST_MAX_TRAFFIC_TAPS 4U
+#endif
+
+static std::array<TrafficTap const*, CPPUTEST_MAX_TRAFFIC_TAPS> l_trafficTaps;
+std::size_t cpputest_trafficTapCount_ = 0U;
+
+static PoolOverflow const* l_poolOverflow = nullptr;
+
+static SchedulingPolicy l_schedulingPolicy = SchedulingPolicy::DRAIN_QUEUE;
+
+// effective preemption threshold of each started active object, by priority
+static std::array<std::uint8_t, QF_MAX_ACTIVE + 1U> l_preemptionThreshold;
+
+// queue length of each started active object, by priority
+static std::array<std::uint_fast16_t, QF_MAX_ACTIVE + 1U> l_queueLength;
+
+// preemption threshold of the running active object, 0 outside dispatch
+static std::uint_fast8_t l_activeThreshold = 0U;
+
+// priority of the running active object, 0 outside dispatch
+static std::uint_fast8_t l_activePrio = 0U;
+
+// priorities at or below the ceiling may not preempt, see QF_SCHED_LOCK_
+static std::uint_fast8_t l_lockCeiling = 0U;
 
 //****************************************************************************
 void QF::init()
 {
     priv_.maxPool_ = static_cast<uint_fast8_t>(0);
+    l_schedulingPolicy   = SchedulingPolicy::DRAIN_QUEUE;
+    l_activeThreshold    = 0U;
+    l_activePrio         = 0U;
+    l_poolOverflow       = nullptr;
+    l_lockCeiling        = 0U;
+    cpputest_publishing_ = false;
+    l_queueLength.fill(0U);
 #if QP_VERSION < 810
     QP::QF::bzero_(&QP::QTimeEvt::timeEvtHead_[0],sizeof(QP::QTimeEvt::timeEvtHead_));
     QP::QF::bzero_(&QP::QActive::registry_[0], sizeof(QP::QActive::registry_));
@@ -47,15 +100,48 @@ int_t QF::run()
 /**
  * Fake cpputest event loop for QActive. Only loops
  * until queue is empty, then removes it from the
- * ready set.
+ * ready set. Under the QV and QK policies, dispatches
+ * a single event.
  * @param act an active object to run an event loop upon.
  */
 void QActive::evtLoop_(QActive* act)
 {
+    const bool singleEvent =
+      (l_schedulingPolicy != SchedulingPolicy::DRAIN_QUEUE);
+
     while (!act->m_eQueue.isEmpty()) {
         QEvt const* e = act->get_();
+
+        for (std::size_t i = 0U; i < cpputest_trafficTapCount_; ++i) {
+            TrafficTap const* tap = l_trafficTaps[i];
+            if (tap->onReceive != nullptr) {
+                tap->onReceive(tap->context, act, e);
+            }
+        }
+
+        for (std::size_t i = 0U; i < l_dispatchObserverCount; ++i) {
+            DispatchObserver const* observer = l_dispatchObservers[i];
+            if (observer->beforeDispatch != nullptr) {
+                observer->beforeDispatch(observer->context, act, e);
+            }
+        }
+
+        CMS_STATE_COVERAGE_RECORD(act, e);
+        CMS_QF_STATS_DISPATCH(act->m_prio);
         act->dispatch(e, act->m_prio);
+
+        for (std::size_t i = 0U; i < l_dispatchObserverCount; ++i) {
+            DispatchObserver const* observer = l_dispatchObservers[i];
+            if (observer->afterDispatch != nullptr) {
+                observer->afterDispatch(observer->context, act, e);
+            }
+        }
+
         QF::gc(e);
+
+        if (singleEvent) {
+            break;
+        }
     }
 
     if (act->m_eQueue.isEmpty()) {
@@ -63,10 +149,20 @@ void QActive::evtLoop_(QActive* act)
     }
 }
 
-void RunUntilNoReadyActiveObjects()
+// run ready active objects with priorities above 'threshold', choosing
+// the highest again after each evtLoop_().
+static void RunReadyAbove(std::uint_fast8_t threshold)
 {
+    const std::uint_fast8_t preemptedThreshold = l_activeThreshold;
+    const std::uint_fast8_t preemptedPrio      = l_activePrio;
+    const bool preemptedPublish                = cpputest_publishing_;
+    cpputest_publishing_                       = false;
+
     while (cpputest_readySet_.notEmpty()) {
         std::uint_fast8_t p = cpputest_readySet_.findMax();
+        if (p <= threshold) {
+            break;
+        }
 #if QP_VERSION > 800
         QActive* a = QP::QActive::fromRegistry(p);
 #elif QP_VERSION > 700
@@ -79,8 +175,260 @@ void RunUntilNoReadyActiveObjects()
         // (e.g., it must not be stopped)
         Q_ASSERT_ID(320, a != nullptr);
 
+        CMS_QF_STATS_SCHEDULER_PASS();
+        l_activeThreshold = l_preemptionThreshold[p];
+        l_activePrio      = p;
         QActive::evtLoop_(a);
     }
+
+    l_activeThreshold    = preemptedThreshold;
+    l_activePrio         = preemptedPrio;
+    cpputest_publishing_ = preemptedPublish;
+}
+
+void RunUntilNoReadyActiveObjects()
+{
+    RunReadyAbove(0U);
+}
+
+void cpputest_preempt_()
+{
+    // the test itself runs as an ISR would, never preempted
+    if ((l_schedulingPolicy != SchedulingPolicy::QK) ||
+        (l_activeThreshold == 0U)) {
+        return;
+    }
+
+    const std::uint_fast8_t threshold =
+      (l_lockCeiling > l_activeThreshold) ? l_lockCeiling : l_activeThreshold;
+    if (cpputest_readySet_.notEmpty() &&
+        (cpputest_readySet_.findMax() > threshold)) {
+        RunReadyAbove(threshold);
+    }
+}
+
+std::uint_fast8_t cpputest_schedLock_(std::uint_fast8_t ceiling)
+{
+    const std::uint_fast8_t previousCeiling = l_lockCeiling;
+    if (ceiling > l_lockCeiling) {
+        l_lockCeiling = ceiling;
+    }
+    return previousCeiling;
+}
+
+void cpputest_schedUnlock_(std::uint_fast8_t previousCeiling)
+{
+    l_lockCeiling = previousCeiling;
+    cpputest_preempt_();
+}
+
+void SetSchedulingPolicy(SchedulingPolicy policy)
+{
+    l_schedulingPolicy = policy;
+}
+
+SchedulingPolicy GetSchedulingPolicy()
+{
+    return l_schedulingPolicy;
+}
+
+std::uint64_t GetPublishCount()
+{
+    return cpputest_publishCount_;
+}
+
+std::uint_fast8_t GetActivePriority()
+{
+    return l_activePrio;
+}
+
+std::uint_fast16_t GetQueueLength(std::uint_fast8_t prio)
+{
+    return (prio < l_queueLength.size()) ? l_queueLength[prio] : 0U;
+}
+
+std::size_t GetEventSize(QEvt const* e)
+{
+    if (e->poolNum_ != 0U) {
+        return QF::priv_.ePool_[e->poolNum_ - 1U].getBlockSize();
+    }
+    return sizeof(QEvt);
+}
+
+std::array<PortStateRegion, 2> GetPortStateRegions()
+{
+    return {{
+      {static_cast<void*>(l_queueLength.data()), sizeof(l_queueLength)},
+      {static_cast<void*>(l_preemptionThreshold.data()),
+       sizeof(l_preemptionThreshold)},
+    }};
+}
+
+bool AddDispatchObserver(DispatchObserver const* observer)
+{
+    Q_ASSERT_ID(330, observer != nullptr);
+    if (l_dispatchObserverCount >= l_dispatchObservers.size()) {
+        return false;
+    }
+
+    l_dispatchObservers[l_dispatchObserverCount++] = observer;
+    return true;
+}
+
+void RemoveDispatchObserver(DispatchObserver const* observer)
+{
+    for (std::size_t i = 0U; i < l_dispatchObserverCount; ++i) {
+        if (l_dispatchObservers[i] == observer) {
+            // keep the remaining observers in the order they were added
+            for (std::size_t j = i + 1U; j < l_dispatchObserverCount; ++j) {
+                l_dispatchObservers[j - 1U] = l_dispatchObservers[j];
+            }
+            --l_dispatchObserverCount;
+            return;
+        }
+    }
+}
+
+bool AddPoolObserver(PoolObserver const* observer)
+{
+    Q_ASSERT_ID(340, observer != nullptr);
+    if (l_poolObserverCount >= l_poolObservers.size()) {
+        return false;
+    }
+
+    l_poolObservers[l_poolObserverCount++] = observer;
+    return true;
+}
+
+void RemovePoolObserver(PoolObserver const* observer)
+{
+    for (std::size_t i = 0U; i < l_poolObserverCount; ++i) {
+        if (l_poolObservers[i] == observer) {
+            for (std::size_t j = i + 1U; j < l_poolObserverCount; ++j) {
+                l_poolObservers[j - 1U] = l_poolObservers[j];
+            }
+            --l_poolObserverCount;
+            return;
+        }
+    }
+}
+
+bool AddTrafficTap(TrafficTap const* tap)
+{
+    Q_ASSERT_ID(350, tap != nullptr);
+    if (cpputest_trafficTapCount_ >= l_trafficTaps.size()) {
+        return false;
+    }
+
+    l_trafficTaps[cpputest_trafficTapCount_++] = tap;
+    return true;
+}
+
+void RemoveTrafficTap(TrafficTap const* tap)
+{
+    for (std::size_t i = 0U; i < cpputest_trafficTapCount_; ++i) {
+        if (l_trafficTaps[i] == tap) {
+            for (std::size_t j = i + 1U; j < cpputest_trafficTapCount_; ++j) {
+                l_trafficTaps[j - 1U] = l_trafficTaps[j];
+            }
+            --cpputest_trafficTapCount_;
+            return;
+        }
+    }
+}
+
+void cpputest_tapPublish_(QEvt const* e, void const* sender)
+{
+    for (std::size_t i = 0U; i < cpputest_trafficTapCount_; ++i) {
+        TrafficTap const* tap = l_trafficTaps[i];
+        if (tap->onPublish != nullptr) {
+            tap->onPublish(tap->context, e, sender);
+        }
+    }
+}
+
+void cpputest_tapPost_(QEvt const* e, void const* sender)
+{
+    const bool delivery = cpputest_publishing_;
+    for (std::size_t i = 0U; i < cpputest_trafficTapCount_; ++i) {
+        TrafficTap const* tap = l_trafficTaps[i];
+        if (tap->onPost != nullptr) {
+            tap->onPost(tap->context, e, sender, delivery);
+        }
+    }
+}
+
+static std::uint_fast8_t PoolNumber(QMPool const& pool)
+{
+    return static_cast<std::uint_fast8_t>(&pool - &QF::priv_.ePool_[0] + 1);
+}
+
+void* cpputest_poolGet_(QMPool& pool, std::uint_fast16_t margin,
+                        std::uint_fast8_t qsId)
+{
+    void* block = pool.get(margin, qsId);
+    if ((block == nullptr) && (margin == 0U) && (l_poolOverflow != nullptr)) {
+        block = l_poolOverflow->get(l_poolOverflow->context, PoolNumber(pool),
+                                    pool.getBlockSize());
+    }
+
+    if (block != nullptr) {
+        CMS_QF_STATS_POOL_GET(PoolNumber(pool));
+    }
+
+    if ((block != nullptr) && (l_poolObserverCount != 0U)) {
+        const std::uint_fast8_t poolNum = PoolNumber(pool);
+        for (std::size_t i = 0U; i < l_poolObserverCount; ++i) {
+            PoolObserver const* observer = l_poolObservers[i];
+            if (observer->onGet != nullptr) {
+                observer->onGet(observer->context, poolNum, block);
+            }
+        }
+    }
+    return block;
+}
+
+void cpputest_poolPut_(QMPool& pool, void* block, std::uint_fast8_t qsId)
+{
+    CMS_QF_STATS_POOL_PUT(PoolNumber(pool));
+
+    if (l_poolObserverCount != 0U) {
+        const std::uint_fast8_t poolNum = PoolNumber(pool);
+        for (std::size_t i = 0U; i < l_poolObserverCount; ++i) {
+            PoolObserver const* observer = l_poolObservers[i];
+            if (observer->onPut != nullptr) {
+                observer->onPut(observer->context, poolNum, block);
+            }
+        }
+    }
+    if ((l_poolOverflow != nullptr) &&
+        l_poolOverflow->put(l_poolOverflow->context, PoolNumber(pool), block)) {
+        return;
+    }
+
+    pool.put(block, qsId);
+}
+
+#ifdef CMS_ENABLE_QF_STATS
+void cpputest_statsOnPublish_()
+{
+    CMS_QF_STATS_PUBLISH();
+}
+
+void cpputest_statsOnPost_()
+{
+    if (cpputest_publishing_) {
+        CMS_QF_STATS_DELIVERY();
+    }
+    else {
+        CMS_QF_STATS_POST();
+    }
+}
+#endif
+
+void SetPoolOverflow(PoolOverflow const* overflow)
+{
+    l_poolOverflow = overflow;
 }
 
 //............................................................................
@@ -102,7 +450,11 @@ void QActive::start(QPrioSpec const prioSpec, QEvt const** const qSto,
     m_pthre = static_cast<std::uint8_t>(prioSpec >> 8U);     // preemption-thre.
     register_();   // make QF aware of this AO
 
+    // a threshold below the priority (e.g. none given) is the priority
+    l_preemptionThreshold[m_prio] = (m_pthre > m_prio) ? m_pthre : m_prio;
+
     m_eQueue.init(qSto, qLen);
+    l_queueLength[m_prio] = qLen;
 
     this->init(par, m_prio);   // execute initial transition (virtual call)
     QS_FLUSH();                // flush the QS trace buffer to the host
@@ -114,6 +466,7 @@ void QActive::stop()
 {
     unsubscribeAll();
     cpputest_readySet_.remove(m_prio);
+    l_queueLength[m_prio] = 0U;
     unregister_();
 }
 #endif
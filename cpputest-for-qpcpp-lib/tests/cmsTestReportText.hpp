@@ -0,0 +1,58 @@
+/// @brief Test helper reading back the text of a report.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#ifndef CMS_TEST_REPORT_TEXT_HPP
+#define CMS_TEST_REPORT_TEXT_HPP
+
+#include <array>
+#include <cstdio>
+#include <string>
+
+namespace cms {
+namespace test {
+
+/// Write a report, such as leaks::Report(), to a temporary file.
+/// \return true if the report's text contains 'text'.
+inline bool ReportContains(void (*report)(std::FILE*), const char* text)
+{
+    std::FILE* out = std::tmpfile();
+    if (out == nullptr) {
+        return false;
+    }
+    report(out);
+    std::rewind(out);
+
+    std::string written;
+    std::array<char, 512> chunk {};
+    size_t length = 0;
+    while ((length = std::fread(chunk.data(), 1, chunk.size(), out)) != 0U) {
+        written.append(chunk.data(), length);
+    }
+    std::fclose(out);
+    return written.find(text) != std::string::npos;
+}
+
+}   // namespace test
+}   // namespace cms
+
+#endif   // CMS_TEST_REPORT_TEXT_HPP
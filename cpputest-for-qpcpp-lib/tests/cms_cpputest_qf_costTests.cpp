@@ -0,0 +1,198 @@
+/// @brief Tests for the simulated CPU cost model.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_cost.hpp"
+#include "cmsDummyActiveObject.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <cstdio>
+#include "cmsTestReportText.hpp"
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+namespace {
+
+constexpr enum_t WORK_SIG  = QP::Q_USER_SIG;
+constexpr enum_t OTHER_SIG = QP::Q_USER_SIG + 1;
+
+constexpr uint32_t TICKS_PER_SECOND = 1000;   // one tick per millisecond
+
+}   // namespace
+
+TEST_GROUP(qf_ctrlCostTests)
+{
+    cms::test::DefaultDummyActiveObject* mDummy = nullptr;
+
+    void setup() final
+    {
+        qf_ctrl::Setup(QP::Q_USER_SIG, TICKS_PER_SECOND);
+        mDummy = new cms::test::DefaultDummyActiveObject();
+        mDummy->dummyStart();
+        mDummy->SetPostedEventHandler([](QP::QEvt const*) {});
+    }
+
+    void teardown() final
+    {
+        qf_ctrl::Teardown();
+        delete mDummy;
+        cost::Clear();
+    }
+
+    cost::ActiveObjectStats Stats()
+    {
+        cost::ActiveObjectStats stats {};
+        CHECK_TRUE(cost::GetStats(mDummy, &stats));
+        return stats;
+    }
+};
+
+TEST(qf_ctrlCostTests, teardown_disables_the_cost_model)
+{
+    cost::Enable();
+    CHECK_TRUE(cost::IsEnabled());
+    qf_ctrl::Teardown();
+    CHECK_FALSE(cost::IsEnabled());
+    qf_ctrl::Setup(QP::Q_USER_SIG, TICKS_PER_SECOND);
+}
+
+TEST(qf_ctrlCostTests, queued_events_wait_for_the_cpu)
+{
+    static const QP::QEvt work(WORK_SIG);
+    CHECK_TRUE(cost::DeclareCost(mDummy, WORK_SIG, microseconds(300)));
+    cost::Enable();
+
+    mDummy->POST(&work, nullptr);
+    mDummy->POST(&work, nullptr);
+    qf_ctrl::ProcessEvents();
+
+    const auto stats = Stats();
+    CHECK_EQUAL(2U, stats.dispatches);
+    CHECK_EQUAL(600, stats.busy.count());
+    CHECK_EQUAL(600, stats.worstResponse.count());
+    CHECK_EQUAL(WORK_SIG, stats.worstResponseSig);
+    CHECK_EQUAL(600, cost::Backlog().count());
+
+    qf_ctrl::MoveTimeForward(milliseconds(1));
+    CHECK_EQUAL(0, cost::Backlog().count());
+}
+
+TEST(qf_ctrlCostTests, responses_over_the_deadline_are_counted)
+{
+    static const QP::QEvt work(WORK_SIG);
+    cost::DeclareCost(mDummy, WORK_SIG, microseconds(300));
+    cost::SetDeadline(mDummy, microseconds(500));
+    cost::Enable();
+
+    // the second event waits for the first
+    mDummy->POST(&work, nullptr);
+    mDummy->POST(&work, nullptr);
+    qf_ctrl::ProcessEvents();
+    CHECK_EQUAL(2U, Stats().dispatches);
+    CHECK_EQUAL(1U, Stats().deadlineMisses);
+    CHECK_EQUAL(500, Stats().deadline.count());
+}
+
+TEST(qf_ctrlCostTests, an_overloaded_cpu_falls_further_behind_each_tick)
+{
+    cost::DeclareCost(mDummy, WORK_SIG, microseconds(1500));
+    cost::Enable();
+
+    qf_ctrl::Every(milliseconds(1)).Post(mDummy, WORK_SIG);
+    qf_ctrl::MoveTimeForward(milliseconds(10));
+
+    // dispatched once the CPU is free, at 1, 3, 5 and 8 ms, each time
+    // draining the events queued while it was busy.
+    const auto stats = Stats();
+    CHECK_EQUAL(7U, stats.dispatches);
+    CHECK_EQUAL(4500, stats.worstResponse.count());
+    CHECK_EQUAL(2500, cost::Backlog().count());
+    CHECK_EQUAL(10500, cost::Busy().count());
+
+    // free the three events still queued
+    cost::Disable();
+    qf_ctrl::ProcessEvents();
+}
+
+TEST(qf_ctrlCostTests, a_busy_cpu_holds_events_in_the_queue)
+{
+    static const QP::QEvt work(WORK_SIG);
+    static const QP::QEvt probe(OTHER_SIG);
+    cost::DeclareCost(mDummy, WORK_SIG, microseconds(1500));
+    cost::Enable();
+
+    for (int i = 0; i < 4; ++i) {
+        qf_ctrl::PostAndProcess(&work, mDummy);
+    }
+    CHECK_EQUAL(1U, Stats().dispatches);
+
+    // three queued events leave too little of the 50 entry queue
+    CHECK_FALSE(mDummy->POST_X(&probe, 48U, nullptr));
+
+    // the CPU is still busy at the first tick
+    qf_ctrl::MoveTimeForward(milliseconds(1));
+    CHECK_EQUAL(1U, Stats().dispatches);
+
+    // free at the second, to run the three from 2 ms to 6.5 ms
+    qf_ctrl::MoveTimeForward(milliseconds(1));
+    CHECK_EQUAL(4U, Stats().dispatches);
+    CHECK_EQUAL(4500, Stats().worstResponse.count());
+    CHECK_TRUE(mDummy->POST_X(&probe, 48U, nullptr));
+}
+
+TEST(qf_ctrlCostTests, cost_declared_for_an_active_object_takes_precedence)
+{
+    static const QP::QEvt work(WORK_SIG);
+    static const QP::QEvt other(OTHER_SIG);
+    cost::DeclareCost(nullptr, WORK_SIG, microseconds(100));
+    cost::DeclareCost(nullptr, OTHER_SIG, microseconds(20));
+    cost::DeclareCost(mDummy, WORK_SIG, microseconds(40));
+    cost::Enable();
+
+    mDummy->POST(&work, nullptr);
+    mDummy->POST(&other, nullptr);
+    qf_ctrl::ProcessEvents();
+    CHECK_EQUAL(60, Stats().busy.count());
+}
+
+TEST(qf_ctrlCostTests, undeclared_handlers_cost_nothing_by_default)
+{
+    static const QP::QEvt work(WORK_SIG);
+    cost::Enable();
+    qf_ctrl::PostAndProcess(&work, mDummy);
+    CHECK_EQUAL(1U, Stats().dispatches);
+    CHECK_EQUAL(0, Stats().busy.count());
+}
+
+TEST(qf_ctrlCostTests, report_lists_named_active_objects)
+{
+    static const QP::QEvt work(WORK_SIG);
+    cost::NameActiveObject(mDummy, "dummy");
+    cost::Enable();
+    qf_ctrl::PostAndProcess(&work, mDummy);
+    CHECK_TRUE(ReportContains(&cost::Report, "\ndummy "));
+}
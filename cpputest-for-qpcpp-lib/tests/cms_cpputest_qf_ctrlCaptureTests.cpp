@@ -0,0 +1,304 @@
+/// @brief Tests for the qf_ctrl stimulus capture and replay support.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_capture.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "cmsDummyActiveObject.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+
+namespace {
+
+enum TestSigs : enum_t {
+    RESET_PUB_SIG = QP::Q_USER_SIG,
+    SUM_PUB_SIG,
+    TEST_MAX_PUB_SIG,
+    VALUE_POST_SIG,
+    REPORT_TIMEOUT_SIG
+};
+
+constexpr uint32_t TICKS_PER_SECOND     = 1000;
+constexpr uint32_t REPORT_DELAY_TICKS   = 10;
+constexpr uint32_t SLOW_REPORT_TICKS    = 200;
+constexpr const char* CAPTURE_FILE_NAME = "cms_qf_ctrl_capture_test.bin";
+
+struct ValueEvt : QP::QEvt {
+    constexpr ValueEvt(QP::QSignal sig, int val) noexcept :
+        QP::QEvt(sig), value(val)
+    {
+    }
+    int value;
+};
+
+ValueEvt const* NewValueEvt(enum_t sig, int value)
+{
+    auto e   = Q_NEW(ValueEvt, sig);
+    e->value = value;
+    return e;
+}
+
+/// Sums posted values, publishing the sum a short time after each
+/// value arrives.
+class AccumulatorActiveObject : public QP::QActive {
+public:
+    explicit AccumulatorActiveObject(uint32_t reportDelayTicks) :
+        QP::QActive(Q_STATE_CAST(initial)), sum(0),
+        m_reportDelayTicks(reportDelayTicks), m_queueStorage(),
+        m_report(this, REPORT_TIMEOUT_SIG)
+    {
+        m_queueStorage.fill(nullptr);
+        start(qf_ctrl::UNIT_UNDER_TEST_PRIORITY, m_queueStorage.data(),
+              m_queueStorage.size(), nullptr, 0);
+    }
+
+    int sum;
+
+private:
+    static QP::QState initial(AccumulatorActiveObject* const me,
+                              QP::QEvt const* const)
+    {
+        me->subscribe(RESET_PUB_SIG);
+        return me->tran(Q_STATE_CAST(&running));
+    }
+
+    static QP::QState running(AccumulatorActiveObject* const me,
+                              QP::QEvt const* const e)
+    {
+        QP::QState rtn;
+        switch (e->sig) {
+            case VALUE_POST_SIG:
+                me->sum += static_cast<ValueEvt const*>(e)->value;
+                me->m_report.disarm();
+                me->m_report.armX(me->m_reportDelayTicks, 0);
+                rtn = Q_HANDLED();
+                break;
+            case RESET_PUB_SIG:
+                me->sum = 0;
+                rtn     = Q_HANDLED();
+                break;
+            case REPORT_TIMEOUT_SIG: {
+                auto report = NewValueEvt(SUM_PUB_SIG, me->sum);
+                me->PUBLISH(report, me);
+                rtn = Q_HANDLED();
+            } break;
+            default:
+                rtn = me->super(&top);
+                break;
+        }
+        return rtn;
+    }
+
+    uint32_t m_reportDelayTicks;
+    std::array<QP::QEvt const*, 10> m_queueStorage;
+    QP::QTimeEvt m_report;
+};
+
+// a capture record header, as written by StartCapture()
+struct RawRecordHeader {
+    uint8_t type;
+    uint8_t prio;
+    uint16_t sig;
+    uint32_t length;
+};
+
+constexpr uint8_t RAW_POST_RECORD = 1;
+constexpr uint8_t RAW_TIME_RECORD = 4;
+
+void WriteRawCapture(const RawRecordHeader& header, const void* payload)
+{
+    static constexpr char MAGIC[8] = {'C', 'M', 'S', 'Q', 'C', 'A', 'P', '1'};
+    std::FILE* file = std::fopen(CAPTURE_FILE_NAME, "wb");
+    CHECK_TRUE(file != nullptr);
+    std::fwrite(MAGIC, sizeof(MAGIC), 1, file);
+    std::fwrite(&header, sizeof(header), 1, file);
+    if (header.length != 0U) {
+        std::fwrite(payload, header.length, 1, file);
+    }
+    std::fclose(file);
+}
+
+}   // namespace
+
+TEST_GROUP(qf_ctrlCaptureTests)
+{
+    AccumulatorActiveObject* mUnderTest         = nullptr;
+    DefaultDummyActiveObjectUniquePtr mListener = nullptr;
+    int mSumsPublished                          = 0;
+
+    void setup() final
+    {
+        StartSystem(REPORT_DELAY_TICKS);
+    }
+
+    void teardown() final
+    {
+        StopSystem();
+        std::remove(CAPTURE_FILE_NAME);
+    }
+
+    void StartSystem(uint32_t reportDelayTicks)
+    {
+        qf_ctrl::Setup(TEST_MAX_PUB_SIG, TICKS_PER_SECOND);
+        mSumsPublished = 0;
+        mListener      = CreateAndStartDummyActiveObject();
+        mListener->subscribe(SUM_PUB_SIG);
+        mListener->SetPostedEventHandler(
+          [this](QP::QEvt const*) { ++mSumsPublished; });
+        mUnderTest = new AccumulatorActiveObject(reportDelayTicks);
+    }
+
+    void StopSystem()
+    {
+        qf_ctrl::Teardown();
+        delete mUnderTest;
+        mUnderTest = nullptr;
+        mListener.reset();
+    }
+
+    void ApplyStimulus()
+    {
+        static const ValueEvt staticValue(VALUE_POST_SIG, 5);
+        qf_ctrl::PostAndProcess(&staticValue, mUnderTest);
+        qf_ctrl::PostAndProcess(NewValueEvt(VALUE_POST_SIG, -2),
+                                mUnderTest);
+        qf_ctrl::MoveTimeForward(std::chrono::milliseconds(100));
+        qf_ctrl::PublishAndProcess(RESET_PUB_SIG);
+        qf_ctrl::PostAndProcess(NewValueEvt(VALUE_POST_SIG, 7),
+                                mUnderTest);
+        qf_ctrl::MoveTimeForward(std::chrono::milliseconds(100));
+    }
+
+    void Capture()
+    {
+        CHECK_TRUE(qf_ctrl::StartCapture(CAPTURE_FILE_NAME));
+        qf_ctrl::RegisterCaptureEventSize(VALUE_POST_SIG, sizeof(ValueEvt));
+        CHECK_TRUE(qf_ctrl::IsCapturing());
+        ApplyStimulus();
+        CHECK_TRUE(qf_ctrl::StopCapture());
+        CHECK_FALSE(qf_ctrl::IsCapturing());
+    }
+};
+
+TEST(qf_ctrlCaptureTests, replay_reproduces_the_captured_behavior)
+{
+    Capture();
+    const int capturedSum = mUnderTest->sum;
+    CHECK_EQUAL(7, capturedSum);
+    CHECK_EQUAL(2, mSumsPublished);
+
+    StopSystem();
+    StartSystem(REPORT_DELAY_TICKS);
+
+    auto result = qf_ctrl::Replay(CAPTURE_FILE_NAME);
+    CHECK_TRUE(result.loaded);
+    CHECK_TRUE(result.matched);
+    CHECK_TRUE(result.checks > 0);
+    CHECK_EQUAL(capturedSum, mUnderTest->sum);
+    CHECK_EQUAL(2, mSumsPublished);
+}
+
+TEST(qf_ctrlCaptureTests, replay_reports_first_diverging_record)
+{
+    Capture();
+
+    // a regression: reports are now too slow
+    StopSystem();
+    StartSystem(SLOW_REPORT_TICKS);
+
+    auto result = qf_ctrl::Replay(CAPTURE_FILE_NAME);
+    CHECK_TRUE(result.loaded);
+    CHECK_FALSE(result.matched);
+    CHECK_TRUE(result.mismatchRecord > 0);
+    CHECK_TRUE(result.mismatchRecord <= result.records);
+}
+
+TEST(qf_ctrlCaptureTests, replay_of_missing_file_is_not_loaded)
+{
+    auto result = qf_ctrl::Replay("no_such_capture_file.bin");
+    CHECK_FALSE(result.loaded);
+    CHECK_FALSE(result.matched);
+}
+
+TEST(qf_ctrlCaptureTests, replay_of_truncated_file_is_not_loaded)
+{
+    Capture();
+
+    std::FILE* file = std::fopen(CAPTURE_FILE_NAME, "rb");
+    CHECK_TRUE(file != nullptr);
+    std::vector<char> bytes;
+    for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) {
+        bytes.push_back(static_cast<char>(c));
+    }
+    std::fclose(file);
+
+    // cut the final record's payload short
+    file = std::fopen(CAPTURE_FILE_NAME, "wb");
+    CHECK_TRUE(file != nullptr);
+    std::fwrite(bytes.data(), bytes.size() - 1U, 1, file);
+    std::fclose(file);
+
+    StopSystem();
+    StartSystem(REPORT_DELAY_TICKS);
+
+    auto result = qf_ctrl::Replay(CAPTURE_FILE_NAME);
+    CHECK_FALSE(result.loaded);
+}
+
+TEST(qf_ctrlCaptureTests, replay_rejects_a_short_time_record)
+{
+    const uint32_t ticks = 1;
+    WriteRawCapture(RawRecordHeader {RAW_TIME_RECORD, 0U, 0U, sizeof(ticks)},
+                    &ticks);
+
+    auto result = qf_ctrl::Replay(CAPTURE_FILE_NAME);
+    CHECK_FALSE(result.loaded);
+    CHECK_EQUAL(0, mUnderTest->sum);
+}
+
+TEST(qf_ctrlCaptureTests, replay_rejects_a_post_to_a_missing_active_object)
+{
+    // no active object is started at the highest priority
+    WriteRawCapture(RawRecordHeader {RAW_POST_RECORD, QF_MAX_ACTIVE,
+                                     VALUE_POST_SIG, 0U},
+                    nullptr);
+
+    auto result = qf_ctrl::Replay(CAPTURE_FILE_NAME);
+    CHECK_FALSE(result.loaded);
+    CHECK_EQUAL(0U, qf_ctrl::PoolEventsInUse());
+}
+
+TEST(qf_ctrlCaptureTests, replay_rejects_a_post_beyond_the_priorities)
+{
+    WriteRawCapture(RawRecordHeader {RAW_POST_RECORD, UINT8_MAX,
+                                     VALUE_POST_SIG, 0U},
+                    nullptr);
+
+    auto result = qf_ctrl::Replay(CAPTURE_FILE_NAME);
+    CHECK_FALSE(result.loaded);
+}
@@ -0,0 +1,216 @@
+/// @brief Tests for the qf_ctrl Checkpoint/Restore support.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <chrono>
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+
+namespace {
+
+enum TestSigs : enum_t {
+    COUNT_POST_SIG = QP::Q_USER_SIG,
+    COUNT_PUBLISH_SIG,
+    TEST_MAX_PUB_SIG,
+    TICK_SIG
+};
+
+constexpr uint32_t TICKS_PER_SECOND    = 1000;
+constexpr uint32_t TICK_INTERVAL_TICKS = 100;
+constexpr int PREAMBLE_POST_COUNT      = 200;
+constexpr auto PREAMBLE_DURATION       = std::chrono::milliseconds(40);
+constexpr auto SCHEDULED_POST_TIME     = std::chrono::milliseconds(150);
+
+/// An active object standing in for an expensive to prepare
+/// unit under test. Lives in static storage, so that it keeps
+/// its address across tests.
+class CountingActiveObject : public QP::QActive {
+public:
+    CountingActiveObject() :
+        QP::QActive(Q_STATE_CAST(initial)), posts(0), publishes(0), ticks(0),
+        m_queueStorage(), m_tick(this, TICK_SIG)
+    {
+        m_queueStorage.fill(nullptr);
+    }
+
+    void startUp()
+    {
+        start(qf_ctrl::UNIT_UNDER_TEST_PRIORITY, m_queueStorage.data(),
+              m_queueStorage.size(), nullptr, 0);
+    }
+
+    int posts;
+    int publishes;
+    int ticks;
+
+private:
+    static QP::QState initial(CountingActiveObject* const me,
+                              QP::QEvt const* const)
+    {
+        me->subscribe(COUNT_PUBLISH_SIG);
+        me->m_tick.armX(TICK_INTERVAL_TICKS, TICK_INTERVAL_TICKS);
+        return me->tran(Q_STATE_CAST(&running));
+    }
+
+    static QP::QState running(CountingActiveObject* const me,
+                              QP::QEvt const* const e)
+    {
+        QP::QState rtn;
+        switch (e->sig) {
+            case COUNT_POST_SIG:
+                ++me->posts;
+                rtn = Q_HANDLED();
+                break;
+            case COUNT_PUBLISH_SIG:
+                ++me->publishes;
+                rtn = Q_HANDLED();
+                break;
+            case TICK_SIG:
+                ++me->ticks;
+                rtn = Q_HANDLED();
+                break;
+            default:
+                rtn = me->super(&top);
+                break;
+        }
+        return rtn;
+    }
+
+    std::array<QP::QEvt const*, 10> m_queueStorage;
+    QP::QTimeEvt m_tick;
+};
+
+CountingActiveObject s_underTest;
+int s_preambleRuns = 0;
+
+}   // namespace
+
+TEST_GROUP(qf_ctrlCheckpointTests)
+{
+    void setup() final
+    {
+        qf_ctrl::Setup(TEST_MAX_PUB_SIG, TICKS_PER_SECOND);
+
+        if (qf_ctrl::HasCheckpoint()) {
+            qf_ctrl::Restore();
+            return;
+        }
+
+        ++s_preambleRuns;
+        s_underTest.startUp();
+        for (int i = 0; i < PREAMBLE_POST_COUNT; ++i) {
+            qf_ctrl::PostAndProcess<COUNT_POST_SIG>(&s_underTest);
+        }
+        qf_ctrl::MoveTimeForward(PREAMBLE_DURATION);
+
+        static const QP::QEvt scheduledPost(COUNT_POST_SIG);
+        qf_ctrl::At(SCHEDULED_POST_TIME).Post(&s_underTest, &scheduledPost);
+        qf_ctrl::Checkpoint({qf_ctrl::RegionOf(s_underTest)});
+    }
+
+    void teardown() final
+    {
+        qf_ctrl::Teardown();
+    }
+};
+
+TEST(qf_ctrlCheckpointTests, preamble_runs_only_once_per_group)
+{
+    CHECK_EQUAL(1, s_preambleRuns);
+    CHECK_TRUE(qf_ctrl::HasCheckpoint());
+}
+
+TEST(qf_ctrlCheckpointTests, each_test_starts_from_checkpoint_state_a)
+{
+    CHECK_EQUAL(PREAMBLE_POST_COUNT, s_underTest.posts);
+    qf_ctrl::PostAndProcess<COUNT_POST_SIG>(&s_underTest);
+    CHECK_EQUAL(PREAMBLE_POST_COUNT + 1, s_underTest.posts);
+}
+
+TEST(qf_ctrlCheckpointTests, each_test_starts_from_checkpoint_state_b)
+{
+    CHECK_EQUAL(PREAMBLE_POST_COUNT, s_underTest.posts);
+    qf_ctrl::PostAndProcess<COUNT_POST_SIG>(&s_underTest);
+    CHECK_EQUAL(PREAMBLE_POST_COUNT + 1, s_underTest.posts);
+}
+
+TEST(qf_ctrlCheckpointTests, queue_length_is_restored)
+{
+    CHECK_EQUAL(10U, QP::GetQueueLength(qf_ctrl::UNIT_UNDER_TEST_PRIORITY));
+}
+
+TEST(qf_ctrlCheckpointTests, subscriptions_are_restored)
+{
+    qf_ctrl::PublishAndProcess(COUNT_PUBLISH_SIG);
+    CHECK_EQUAL(1, s_underTest.publishes);
+}
+
+TEST(qf_ctrlCheckpointTests, armed_time_events_are_restored)
+{
+    qf_ctrl::MoveTimeForward(std::chrono::milliseconds(TICK_INTERVAL_TICKS));
+    CHECK_EQUAL(1, s_underTest.ticks);
+}
+
+TEST(qf_ctrlCheckpointTests, clock_and_scheduled_stimuli_are_restored)
+{
+    CHECK_EQUAL(PREAMBLE_DURATION.count(), qf_ctrl::Now().count());
+    CHECK_EQUAL(1U, qf_ctrl::PendingStimuli());
+
+    qf_ctrl::MoveTimeForward(SCHEDULED_POST_TIME - PREAMBLE_DURATION);
+    CHECK_EQUAL(0U, qf_ctrl::PendingStimuli());
+    CHECK_EQUAL(PREAMBLE_POST_COUNT + 1, s_underTest.posts);
+}
+
+TEST(qf_ctrlCheckpointTests, restore_discards_events_left_queued_by_a_test)
+{
+    static const QP::QEvt post(COUNT_POST_SIG);
+    s_underTest.POST(&post, nullptr);
+    qf_ctrl::Restore();
+    qf_ctrl::ProcessEvents();
+    CHECK_EQUAL(PREAMBLE_POST_COUNT, s_underTest.posts);
+}
+
+TEST_GROUP(qf_ctrlCheckpointOwnershipTests)
+{
+    void setup() final
+    {
+        qf_ctrl::Setup(TEST_MAX_PUB_SIG, TICKS_PER_SECOND);
+    }
+
+    void teardown() final
+    {
+        qf_ctrl::DiscardCheckpoint();
+        qf_ctrl::Teardown();
+    }
+};
+
+TEST(qf_ctrlCheckpointOwnershipTests, checkpoint_belongs_to_capturing_group)
+{
+    qf_ctrl::Checkpoint();
+    CHECK_TRUE(qf_ctrl::HasCheckpoint());
+    qf_ctrl::DiscardCheckpoint();
+    CHECK_FALSE(qf_ctrl::HasCheckpoint());
+}
@@ -87,6 +87,32 @@ TEST(qf_ctrlTests, setup_will_create_one_pool_when_requested)
     ConfirmPoolEventSize(0, sizeof(uint64_t) * 10);
 }
 
+TEST(qf_ctrlTests, setup_reuses_the_previous_tests_pool_storage)
+{
+    qf_ctrl::Setup(10, 1000);
+    QP::QEvt const* first = Q_NEW(QP::QEvt, 5);
+    QP::QF::gc(first);
+    qf_ctrl::Teardown();
+
+    qf_ctrl::Setup(10, 1000);
+    QP::QEvt const* second = Q_NEW(QP::QEvt, 5);
+    QP::QF::gc(second);
+    POINTERS_EQUAL(first, second);
+}
+
+TEST(qf_ctrlTests, setup_provides_large_pools)
+{
+    qf_ctrl::MemPoolConfigs configs;
+    configs.push_back(qf_ctrl::MemPoolConfig {sizeof(uint64_t) * 8, 60000});
+
+    qf_ctrl::Setup(10, 1000, configs);
+    ConfirmNumberOfPools(1);
+
+    QP::QEvt const* e = Q_NEW(QP::QEvt, 5);
+    CHECK_TRUE(e != nullptr);
+    QP::QF::gc(e);
+}
+
 TEST(qf_ctrlTests, setup_provides_option_to_skip_memory_pool_leak_detection)
 {
     qf_ctrl::Setup(10, 1000, qf_ctrl::MemPoolConfigs {},
@@ -0,0 +1,164 @@
+/// @brief Tests for the qf_ctrl virtual clock and timeline of stimuli.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cmsDummyActiveObject.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <chrono>
+#include <vector>
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+using std::chrono::milliseconds;
+
+namespace {
+
+enum TestSigs : enum_t {
+    TICK_PUB_SIG = QP::Q_USER_SIG,
+    TEST_MAX_PUB_SIG,
+    FIRST_POST_SIG,
+    SECOND_POST_SIG,
+    THIRD_POST_SIG
+};
+
+constexpr uint32_t TICKS_PER_SECOND = 100;
+
+struct Delivery {
+    enum_t sig;
+    milliseconds time;
+};
+
+}   // namespace
+
+TEST_GROUP(qf_ctrlTimelineTests)
+{
+    cms::test::DefaultDummyActiveObject* mDummy = nullptr;
+    std::vector<Delivery> mDeliveries;
+
+    void setup() final
+    {
+        qf_ctrl::Setup(TEST_MAX_PUB_SIG, TICKS_PER_SECOND);
+        mDummy = new cms::test::DefaultDummyActiveObject();
+        mDummy->dummyStart();
+        mDummy->SetPostedEventHandler([this](QP::QEvt const* e) {
+            mDeliveries.push_back(Delivery {e->sig, qf_ctrl::Now()});
+        });
+    }
+
+    void teardown() final
+    {
+        qf_ctrl::Teardown();
+        delete mDummy;
+        mDeliveries.clear();
+        mDeliveries.shrink_to_fit();
+    }
+};
+
+TEST(qf_ctrlTimelineTests, virtual_clock_starts_at_zero_and_follows_time)
+{
+    CHECK_EQUAL(0, qf_ctrl::Now().count());
+    CHECK_EQUAL(0U, qf_ctrl::TicksSinceSetup());
+
+    qf_ctrl::MoveTimeForward(milliseconds(250));
+    CHECK_EQUAL(250, qf_ctrl::Now().count());
+    CHECK_EQUAL(25U, qf_ctrl::TicksSinceSetup());
+
+    qf_ctrl::MoveTimeForward(std::chrono::seconds(2));
+    CHECK_EQUAL(2250, qf_ctrl::Now().count());
+    CHECK_EQUAL(225U, qf_ctrl::TicksSinceSetup());
+}
+
+TEST(qf_ctrlTimelineTests, stimulus_is_applied_at_its_time)
+{
+    static const QP::QEvt first(FIRST_POST_SIG);
+    qf_ctrl::At(milliseconds(500)).Post(mDummy, &first);
+    CHECK_EQUAL(1U, qf_ctrl::PendingStimuli());
+
+    qf_ctrl::MoveTimeForward(milliseconds(490));
+    CHECK_TRUE(mDeliveries.empty());
+
+    qf_ctrl::MoveTimeForward(std::chrono::seconds(1));
+    CHECK_EQUAL(1U, mDeliveries.size());
+    CHECK_EQUAL(FIRST_POST_SIG, mDeliveries[0].sig);
+    CHECK_EQUAL(500, mDeliveries[0].time.count());
+    CHECK_EQUAL(0U, qf_ctrl::PendingStimuli());
+    CHECK_EQUAL(1490, qf_ctrl::Now().count());
+}
+
+TEST(qf_ctrlTimelineTests, stimuli_are_applied_in_time_then_scheduling_order)
+{
+    qf_ctrl::At(milliseconds(300)).Post(mDummy, THIRD_POST_SIG);
+    qf_ctrl::At(milliseconds(100)).Post(mDummy, FIRST_POST_SIG);
+    qf_ctrl::At(milliseconds(300)).Post(mDummy, SECOND_POST_SIG);
+
+    qf_ctrl::MoveTimeForward(std::chrono::seconds(1));
+
+    CHECK_EQUAL(3U, mDeliveries.size());
+    CHECK_EQUAL(FIRST_POST_SIG, mDeliveries[0].sig);
+    CHECK_EQUAL(100, mDeliveries[0].time.count());
+    CHECK_EQUAL(THIRD_POST_SIG, mDeliveries[1].sig);
+    CHECK_EQUAL(300, mDeliveries[1].time.count());
+    CHECK_EQUAL(SECOND_POST_SIG, mDeliveries[2].sig);
+    CHECK_EQUAL(300, mDeliveries[2].time.count());
+}
+
+TEST(qf_ctrlTimelineTests, after_is_relative_to_now)
+{
+    qf_ctrl::MoveTimeForward(milliseconds(200));
+    qf_ctrl::After(milliseconds(50)).Post(mDummy, FIRST_POST_SIG);
+
+    qf_ctrl::MoveTimeForward(milliseconds(100));
+    CHECK_EQUAL(1U, mDeliveries.size());
+    CHECK_EQUAL(250, mDeliveries[0].time.count());
+}
+
+TEST(qf_ctrlTimelineTests, periodic_publish_repeats_until_cleared)
+{
+    mDummy->subscribe(TICK_PUB_SIG);
+    qf_ctrl::Every(milliseconds(100)).Publish(TICK_PUB_SIG);
+
+    qf_ctrl::MoveTimeForward(milliseconds(450));
+    CHECK_EQUAL(4U, mDeliveries.size());
+    for (size_t i = 0; i < mDeliveries.size(); ++i) {
+        CHECK_EQUAL(TICK_PUB_SIG, mDeliveries[i].sig);
+        CHECK_EQUAL(static_cast<long>(100 * (i + 1)),
+                    static_cast<long>(mDeliveries[i].time.count()));
+    }
+    CHECK_EQUAL(1U, qf_ctrl::PendingStimuli());
+
+    qf_ctrl::ClearTimeline();
+    qf_ctrl::MoveTimeForward(milliseconds(450));
+    CHECK_EQUAL(4U, mDeliveries.size());
+}
+
+TEST(qf_ctrlTimelineTests, pool_event_never_applied_is_recycled_by_teardown)
+{
+    qf_ctrl::At(std::chrono::seconds(10))
+      .Post(mDummy, Q_NEW(QP::QEvt, FIRST_POST_SIG));
+    CHECK_EQUAL(1U, qf_ctrl::PoolEventsInUse());
+
+    qf_ctrl::MoveTimeForward(std::chrono::seconds(1));
+    CHECK_TRUE(mDeliveries.empty());
+}
@@ -0,0 +1,214 @@
+/// @brief Tests for the active object fuzzing harness.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_fuzz.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <cstdint>
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+
+namespace {
+
+enum TestSigs : enum_t {
+    RESET_PUB_SIG = QP::Q_USER_SIG,
+    TEST_MAX_PUB_SIG,
+    ADD_POST_SIG,
+    HOLD_POST_SIG,
+    TIMEOUT_SIG
+};
+
+struct AddEvt : QP::QEvt {
+    uint8_t amount;
+};
+
+// only 'amount' is taken from the fuzzer input
+constexpr size_t ADD_EVT_FUZZ_SIZE = sizeof(QP::QEvt) + sizeof(uint8_t);
+
+/// Sums ADD events. A HOLD event allocates an event which is never
+/// recycled, a deliberate pool leak for the harness to find.
+class FuzzedActiveObject : public QP::QActive {
+public:
+    FuzzedActiveObject() :
+        QP::QActive(Q_STATE_CAST(initial)), sum(0), timeouts(0),
+        held(nullptr), m_queueStorage(), m_timeout(this, TIMEOUT_SIG)
+    {
+        m_queueStorage.fill(nullptr);
+    }
+
+    static void Start();
+
+    uint32_t sum;
+    uint32_t timeouts;
+    QP::QEvt const* held;
+
+private:
+    static QP::QState initial(FuzzedActiveObject* const me,
+                              QP::QEvt const* const)
+    {
+        me->subscribe(RESET_PUB_SIG);
+        me->m_timeout.armX(10, 10);
+        return me->tran(Q_STATE_CAST(&running));
+    }
+
+    static QP::QState running(FuzzedActiveObject* const me,
+                              QP::QEvt const* const e)
+    {
+        QP::QState rtn;
+        switch (e->sig) {
+            case ADD_POST_SIG:
+                me->sum += static_cast<AddEvt const*>(e)->amount;
+                rtn = Q_HANDLED();
+                break;
+            case HOLD_POST_SIG:
+                if (me->held == nullptr) {
+                    me->held = Q_NEW(QP::QEvt, HOLD_POST_SIG);
+                }
+                rtn = Q_HANDLED();
+                break;
+            case RESET_PUB_SIG:
+                me->sum = 0;
+                rtn     = Q_HANDLED();
+                break;
+            case TIMEOUT_SIG:
+                ++me->timeouts;
+                rtn = Q_HANDLED();
+                break;
+            default:
+                rtn = me->super(&top);
+                break;
+        }
+        return rtn;
+    }
+
+    std::array<QP::QEvt const*, 8> m_queueStorage;
+    QP::QTimeEvt m_timeout;
+};
+
+FuzzedActiveObject s_underTest;
+
+void FuzzedActiveObject::Start()
+{
+    s_underTest.start(qf_ctrl::UNIT_UNDER_TEST_PRIORITY,
+                      s_underTest.m_queueStorage.data(),
+                      s_underTest.m_queueStorage.size(), nullptr, 0);
+}
+
+fuzz::FuzzTarget MakeFuzzTarget(bool allowHold)
+{
+    fuzz::FuzzTarget target {};
+    target.maxPubSubSignalValue = TEST_MAX_PUB_SIG;
+    target.ticksPerSecond       = 1000;
+    target.startActiveObjects   = &FuzzedActiveObject::Start;
+    target.regions              = {qf_ctrl::RegionOf(s_underTest)};
+    target.postTarget           = &s_underTest;
+    target.postSignals          = {{ADD_POST_SIG, ADD_EVT_FUZZ_SIZE}};
+    if (allowHold) {
+        target.postSignals.push_back({HOLD_POST_SIG, sizeof(QP::QEvt)});
+    }
+    target.publishSignals = {{RESET_PUB_SIG, sizeof(QP::QEvt)}};
+    target.maxTimeStepMs  = 1000;
+    return target;
+}
+
+// operation bytes, see cms::test::fuzz::RunOneInput()
+constexpr uint8_t OP_POST    = 0;
+constexpr uint8_t OP_PUBLISH = 1;
+constexpr uint8_t OP_TIME    = 2;
+constexpr uint8_t OP_PROCESS = 3;
+
+}   // namespace
+
+TEST_GROUP(FuzzHarnessTests)
+{
+    void setup() final
+    {
+    }
+
+    void teardown() final
+    {
+        fuzz::Shutdown();
+    }
+};
+
+TEST(FuzzHarnessTests, input_operations_are_applied_to_the_target)
+{
+    fuzz::Initialize(MakeFuzzTarget(false));
+
+    const uint8_t input[] = {OP_POST, 0, 5, OP_POST, 0, 7, OP_PROCESS,
+                             OP_TIME, 100, 0};
+    CHECK_TRUE(fuzz::RunOneInput(input, sizeof(input)) ==
+               fuzz::InputResult::OK);
+    CHECK_EQUAL(12U, s_underTest.sum);
+    CHECK_EQUAL(10U, s_underTest.timeouts);
+}
+
+TEST(FuzzHarnessTests, each_input_starts_from_the_initialized_state)
+{
+    fuzz::Initialize(MakeFuzzTarget(false));
+
+    const uint8_t first[] = {OP_POST, 0, 200, OP_TIME, 50, 0};
+    fuzz::RunOneInput(first, sizeof(first));
+    CHECK_EQUAL(200U, s_underTest.sum);
+
+    const uint8_t second[] = {OP_POST, 0, 1};
+    fuzz::RunOneInput(second, sizeof(second));
+    CHECK_EQUAL(1U, s_underTest.sum);
+    CHECK_EQUAL(0U, s_underTest.timeouts);
+}
+
+TEST(FuzzHarnessTests, publish_operations_reach_subscribers)
+{
+    fuzz::Initialize(MakeFuzzTarget(false));
+
+    const uint8_t input[] = {OP_POST, 0, 9, OP_PROCESS, OP_PUBLISH, 0};
+    fuzz::RunOneInput(input, sizeof(input));
+    CHECK_EQUAL(0U, s_underTest.sum);
+}
+
+TEST(FuzzHarnessTests, truncated_and_empty_inputs_are_harmless)
+{
+    fuzz::Initialize(MakeFuzzTarget(false));
+
+    const uint8_t truncated[] = {OP_POST, 0, 3, OP_TIME, 1};
+    CHECK_TRUE(fuzz::RunOneInput(truncated, sizeof(truncated)) ==
+               fuzz::InputResult::OK);
+    CHECK_EQUAL(3U, s_underTest.sum);
+    CHECK_TRUE(fuzz::RunOneInput(nullptr, 0) == fuzz::InputResult::OK);
+}
+
+TEST(FuzzHarnessTests, a_held_pool_event_is_reported_as_a_leak)
+{
+    fuzz::Initialize(MakeFuzzTarget(true));
+
+    const uint8_t leaky[] = {OP_POST, 1, OP_PROCESS};
+    CHECK_TRUE(fuzz::RunOneInput(leaky, sizeof(leaky)) ==
+               fuzz::InputResult::POOL_LEAK);
+
+    // the next input starts from fresh pools
+    const uint8_t clean[] = {OP_POST, 0, 1};
+    CHECK_TRUE(fuzz::RunOneInput(clean, sizeof(clean)) ==
+               fuzz::InputResult::OK);
+}
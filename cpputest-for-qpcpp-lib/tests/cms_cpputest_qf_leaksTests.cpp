@@ -0,0 +1,188 @@
+/// @brief Tests for pool event leak tracking.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_leaks.hpp"
+#include "cmsDummyActiveObject.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+#include "cmsTestReportText.hpp"
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+
+namespace {
+
+constexpr enum_t MAX_PUB_SIG = QP::Q_USER_SIG + 10;
+constexpr enum_t SIG_A       = QP::Q_USER_SIG + 1;
+constexpr enum_t SIG_B       = QP::Q_USER_SIG + 2;
+
+}   // namespace
+
+TEST_GROUP(qf_ctrlLeaksTests)
+{
+    std::vector<QP::QEvt const*> mHeld;
+    DefaultDummyActiveObjectUniquePtr mDummy;
+
+    void setup() final
+    {
+        qf_ctrl::Setup(MAX_PUB_SIG, 100);
+        leaks::Enable();
+    }
+
+    void teardown() final
+    {
+        Release();
+        mHeld.shrink_to_fit();
+        leaks::Disable();
+        qf_ctrl::Teardown();
+        mDummy.reset();
+    }
+
+    void Hold(enum_t sig)
+    {
+        mHeld.push_back(Q_NEW(QP::QEvt, sig));
+    }
+
+    void Release()
+    {
+        for (auto e : mHeld) {
+            QP::QF::gc(e);
+        }
+        mHeld.clear();
+    }
+};
+
+TEST(qf_ctrlLeaksTests, tracks_allocations_until_recycled)
+{
+    Hold(SIG_A);
+    Hold(SIG_A);
+    Hold(SIG_B);
+    CHECK_EQUAL(3U, leaks::LiveCount());
+    CHECK_EQUAL(2U, leaks::LiveCount(SIG_A));
+    CHECK_EQUAL(1U, leaks::LiveCount(SIG_B));
+
+    Release();
+    CHECK_EQUAL(0U, leaks::LiveCount());
+    CHECK_EQUAL(0U, leaks::LiveCount(SIG_A));
+}
+
+TEST(qf_ctrlLeaksTests, an_event_processed_by_an_active_object_is_not_live)
+{
+    mDummy = CreateAndStartDummyActiveObject();
+    mDummy->POST(Q_NEW(QP::QEvt, SIG_A), 0);
+    CHECK_EQUAL(1U, leaks::LiveCount());
+
+    qf_ctrl::ProcessEvents();
+    CHECK_EQUAL(0U, leaks::LiveCount());
+}
+
+TEST(qf_ctrlLeaksTests, records_the_allocation_order_tick_and_pool)
+{
+    Hold(SIG_A);
+    qf_ctrl::MoveTimeForward(std::chrono::milliseconds(50));
+    Hold(SIG_B);
+
+    auto first  = leaks::Find(mHeld[0]);
+    auto second = leaks::Find(mHeld[1]);
+    CHECK_TRUE(first != nullptr);
+    CHECK_TRUE(second != nullptr);
+    CHECK_EQUAL(1U, first->sequence);
+    CHECK_EQUAL(2U, second->sequence);
+    CHECK_EQUAL(0U, first->tick);
+    CHECK_EQUAL(5U, second->tick);
+    CHECK_EQUAL(1U, first->poolNum);
+    CHECK_EQUAL(0U, first->prio);
+}
+
+TEST(qf_ctrlLeaksTests, records_the_allocating_active_object)
+{
+    mDummy = CreateAndStartDummyActiveObject();
+    mDummy->SetPostedEventHandler([this](QP::QEvt const*) { Hold(SIG_B); });
+    mDummy->POST(Q_NEW(QP::QEvt, SIG_A), 0);
+    qf_ctrl::ProcessEvents();
+
+    auto held = leaks::Find(mHeld[0]);
+    CHECK_TRUE(held != nullptr);
+    CHECK_EQUAL(qf_ctrl::DUMMY_AO_A_PRIORITY, held->prio);
+}
+
+TEST(qf_ctrlLeaksTests, removal_keeps_colliding_blocks_findable)
+{
+    for (int i = 0; i < 20; ++i) {
+        Hold(SIG_A);
+    }
+
+    // recycle every other block, leaving holes in any probe runs
+    for (size_t i = 0; i < mHeld.size(); i += 2) {
+        QP::QF::gc(mHeld[i]);
+        mHeld[i] = nullptr;
+    }
+    mHeld.erase(std::remove(mHeld.begin(), mHeld.end(), nullptr), mHeld.end());
+
+    CHECK_EQUAL(10U, leaks::LiveCount());
+    for (auto e : mHeld) {
+        CHECK_TRUE(leaks::Find(e) != nullptr);
+    }
+}
+
+TEST(qf_ctrlLeaksTests, report_groups_live_events_by_signal_and_origin)
+{
+    Hold(SIG_A);
+    Hold(SIG_A);
+
+    mDummy = CreateAndStartDummyActiveObject();
+    mDummy->SetPostedEventHandler([this](QP::QEvt const*) { Hold(SIG_B); });
+    mDummy->POST(Q_NEW(QP::QEvt, SIG_A), 0);
+    qf_ctrl::ProcessEvents();
+
+    CHECK_TRUE(ReportContains(&leaks::Report, "Live pool events: 3"));
+
+    char expected[64];
+    std::snprintf(expected, sizeof(expected), "sig %d x2, allocated by the test",
+                  SIG_A);
+    CHECK_TRUE(ReportContains(&leaks::Report, expected));
+    std::snprintf(expected, sizeof(expected),
+                  "sig %d x1, allocated by active object prio %u", SIG_B,
+                  static_cast<unsigned>(qf_ctrl::DUMMY_AO_A_PRIORITY));
+    CHECK_TRUE(ReportContains(&leaks::Report, expected));
+}
+
+TEST(qf_ctrlLeaksTests, setup_forgets_the_previous_test)
+{
+    Hold(SIG_A);
+
+    // as a leaking test ending and the next one starting
+    leaks::Disable();
+    qf_ctrl::ChangeMemPoolTeardownOption(qf_ctrl::MemPoolTeardownOption::IGNORE);
+    qf_ctrl::Teardown();
+    mHeld.clear();
+    qf_ctrl::Setup(MAX_PUB_SIG, 100);
+    leaks::Enable();
+
+    CHECK_EQUAL(0U, leaks::LiveCount());
+}
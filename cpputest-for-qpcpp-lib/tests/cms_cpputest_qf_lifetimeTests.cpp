@@ -0,0 +1,172 @@
+/// @brief Tests for the pool event lifetime histograms.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_lifetime.hpp"
+#include "cmsDummyActiveObject.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <chrono>
+#include <cstdio>
+#include "cmsTestReportText.hpp"
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+using namespace std::chrono_literals;
+
+namespace {
+
+// The histograms add up across tests, perhaps for a suite report (see
+// CMS_EVENT_LIFETIME_REPORT), so each test uses a signal no other test
+// of the suite does.
+constexpr enum_t FIRST_SIG     = QP::Q_USER_SIG + 200;
+constexpr enum_t HELD_SIG      = FIRST_SIG;
+constexpr enum_t PUBLISHED_SIG = FIRST_SIG + 1;
+constexpr enum_t STATIC_SIG    = FIRST_SIG + 2;
+constexpr enum_t DISABLED_SIG  = FIRST_SIG + 3;
+constexpr enum_t REPORTED_SIG  = FIRST_SIG + 4;
+constexpr enum_t MAX_PUB_SIG   = FIRST_SIG + 5;
+
+}   // namespace
+
+TEST_GROUP(qf_ctrlLifetimeTests)
+{
+    DefaultDummyActiveObjectUniquePtr mDummyA;
+    DefaultDummyActiveObjectUniquePtr mDummyB;
+    bool mWasEnabled = false;
+
+    void setup() final
+    {
+        qf_ctrl::Setup(MAX_PUB_SIG, 1000);
+        mWasEnabled = lifetime::IsEnabled();
+        lifetime::Enable();
+        mDummyA = CreateAndStartDummyActiveObject(
+          DefaultDummyActiveObject::EventBehavior::CALLBACK,
+          qf_ctrl::DUMMY_AO_A_PRIORITY);
+        mDummyB = CreateAndStartDummyActiveObject(
+          DefaultDummyActiveObject::EventBehavior::CALLBACK,
+          qf_ctrl::DUMMY_AO_B_PRIORITY);
+    }
+
+    void teardown() final
+    {
+        if (!mWasEnabled) {
+            lifetime::Disable();
+        }
+        qf_ctrl::Teardown();
+        mDummyA.reset();
+        mDummyB.reset();
+    }
+};
+
+TEST(qf_ctrlLifetimeTests, lifetime_runs_from_allocation_to_recycle)
+{
+    auto e = Q_NEW(QP::QEvt, HELD_SIG);
+    qf_ctrl::MoveTimeForward(20ms);
+    mDummyA->POST(e, nullptr);
+    qf_ctrl::ProcessEvents();
+
+    auto signal = lifetime::Find(HELD_SIG);
+    CHECK_TRUE(signal != nullptr);
+    CHECK_EQUAL(1U, signal->lifetimeTicks.count);
+    CHECK_EQUAL(20U, signal->lifetimeTicks.max);
+    CHECK_EQUAL(1U, signal->queueTicks.count);
+    CHECK_EQUAL(20U, signal->queueTicks.max);
+    CHECK_TRUE(signal->lifetimeNs.count == 1U);
+}
+
+TEST(qf_ctrlLifetimeTests, each_dispatch_restarts_the_queueing_delay)
+{
+    mDummyA->subscribe(PUBLISHED_SIG);
+    mDummyB->subscribe(PUBLISHED_SIG);
+
+    auto e = Q_NEW(QP::QEvt, PUBLISHED_SIG);
+    qf_ctrl::MoveTimeForward(10ms);
+    qf_ctrl::PublishEvent(e);
+    qf_ctrl::ProcessEvents();
+
+    auto signal = lifetime::Find(PUBLISHED_SIG);
+    CHECK_TRUE(signal != nullptr);
+    CHECK_EQUAL(1U, signal->lifetimeTicks.count);
+    CHECK_EQUAL(10U, signal->lifetimeTicks.max);
+
+    // 10 ticks to the first dispatch, none from it to the second
+    CHECK_EQUAL(2U, signal->queueTicks.count);
+    CHECK_EQUAL(10U, signal->queueTicks.sum);
+    CHECK_EQUAL(0U, signal->queueTicks.Percentile(50.0));
+    CHECK_EQUAL(10U, signal->queueTicks.Percentile(100.0));
+}
+
+TEST(qf_ctrlLifetimeTests, static_events_are_not_stamped)
+{
+    static const QP::QEvt event(STATIC_SIG);
+    mDummyA->POST(&event, nullptr);
+    qf_ctrl::ProcessEvents();
+
+    CHECK_TRUE(lifetime::Find(STATIC_SIG) == nullptr);
+}
+
+TEST(qf_ctrlLifetimeTests, nothing_is_stamped_while_disabled)
+{
+    if (mWasEnabled) {
+        return;   // enabled for the whole suite
+    }
+
+    lifetime::Disable();
+    mDummyA->subscribe(DISABLED_SIG);
+    qf_ctrl::PublishAndProcess(DISABLED_SIG);
+
+    CHECK_TRUE(lifetime::Find(DISABLED_SIG) == nullptr);
+}
+
+TEST(qf_ctrlLifetimeTests, report_has_a_line_per_signal)
+{
+    mDummyA->subscribe(REPORTED_SIG);
+    qf_ctrl::PublishAndProcess(REPORTED_SIG);
+
+    char expected[32];
+    std::snprintf(expected, sizeof(expected), "sig %d: 1 events",
+                  static_cast<int>(REPORTED_SIG));
+    CHECK_TRUE(ReportContains(&lifetime::Report, expected));
+}
+
+TEST(qf_ctrlLifetimeTests, histogram_buckets_are_powers_of_two)
+{
+    lifetime::Histogram histogram {};
+    for (uint64_t value : {0U, 1U, 2U, 3U, 100U}) {
+        histogram.Add(value);
+    }
+
+    CHECK_EQUAL(5U, histogram.count);
+    CHECK_EQUAL(106U, histogram.sum);
+    CHECK_EQUAL(100U, histogram.max);
+    CHECK_EQUAL(1U, histogram.buckets[0]);
+    CHECK_EQUAL(1U, histogram.buckets[1]);
+    CHECK_EQUAL(2U, histogram.buckets[2]);
+    CHECK_EQUAL(1U, histogram.buckets[7]);
+
+    // the top of the bucket holding the percentile, at most the maximum
+    CHECK_EQUAL(3U, histogram.Percentile(60.0));
+    CHECK_EQUAL(100U, histogram.Percentile(100.0));
+}
@@ -0,0 +1,131 @@
+/// @brief Tests for the per test cost metrics.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_metrics.hpp"
+#include "cmsDummyActiveObject.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <chrono>
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr enum_t MAX_PUB_SIG = QP::Q_USER_SIG + 10;
+constexpr enum_t SIG_A       = QP::Q_USER_SIG + 1;
+
+}   // namespace
+
+TEST_GROUP(qf_ctrlMetricsTests)
+{
+    DefaultDummyActiveObjectUniquePtr mDummy;
+
+    void setup() final
+    {
+        qf_ctrl::Setup(MAX_PUB_SIG, 1000);
+        mDummy = CreateAndStartDummyActiveObject();
+        metrics::BeginTest();
+    }
+
+    void teardown() final
+    {
+        qf_ctrl::Teardown();
+        mDummy.reset();
+    }
+};
+
+TEST(qf_ctrlMetricsTests, counts_dispatched_and_published_events)
+{
+    mDummy->subscribe(SIG_A);
+    qf_ctrl::PublishEvent(SIG_A);
+    qf_ctrl::PublishEvent(SIG_A);
+    mDummy->POST(Q_NEW(QP::QEvt, SIG_A), 0);
+    qf_ctrl::ProcessEvents();
+
+    const auto m = metrics::Current();
+    CHECK_EQUAL(3U, m.dispatched);
+    CHECK_EQUAL(2U, m.published);
+}
+
+TEST(qf_ctrlMetricsTests, records_the_most_pool_events_in_use)
+{
+    std::array<QP::QEvt const*, 3> held {};
+    for (auto& e : held) {
+        e = Q_NEW(QP::QEvt, SIG_A);
+    }
+    for (auto e : held) {
+        QP::QF::gc(e);
+    }
+    QP::QF::gc(Q_NEW(QP::QEvt, SIG_A));
+
+    CHECK_EQUAL(3U, metrics::Current().poolPeak);
+}
+
+TEST(qf_ctrlMetricsTests, records_the_most_events_queued_on_an_active_object)
+{
+    for (int i = 0; i < 4; ++i) {
+        mDummy->POST(Q_NEW(QP::QEvt, SIG_A), 0);
+    }
+    qf_ctrl::ProcessEvents();
+    mDummy->POST(Q_NEW(QP::QEvt, SIG_A), 0);
+    qf_ctrl::ProcessEvents();
+
+    CHECK_EQUAL(4U, metrics::Current().queuePeak);
+}
+
+TEST(qf_ctrlMetricsTests, counts_simulated_and_active_ticks)
+{
+    qf_ctrl::MoveTimeForward(100ms);
+    mDummy->POST(Q_NEW(QP::QEvt, SIG_A), 0);
+    qf_ctrl::MoveTimeForward(10ms);
+
+    const auto m = metrics::Current();
+    CHECK_EQUAL(110U, m.ticks);
+    CHECK_EQUAL(1U, m.activeTicks);
+    CHECK_FALSE(m.idleTicks);
+}
+
+TEST(qf_ctrlMetricsTests, flags_a_test_simulating_mostly_idle_ticks)
+{
+    qf_ctrl::MoveTimeForward(20s);
+
+    const auto m = metrics::Current();
+    CHECK_EQUAL(20000U, m.ticks);
+    CHECK_EQUAL(0U, m.activeTicks);
+    CHECK_TRUE(m.idleTicks);
+}
+
+TEST(qf_ctrlMetricsTests, ticks_sum_over_each_setup)
+{
+    qf_ctrl::MoveTimeForward(20ms);
+    qf_ctrl::Teardown();
+    qf_ctrl::Setup(MAX_PUB_SIG, 1000);
+    qf_ctrl::MoveTimeForward(30ms);
+
+    CHECK_EQUAL(50U, metrics::Current().ticks);
+}
@@ -0,0 +1,155 @@
+/// @brief Tests for event pool overflow.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_pool_overflow.hpp"
+#include "cmsDummyActiveObject.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <cstdio>
+#include <vector>
+#include "cmsTestReportText.hpp"
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+
+namespace {
+
+constexpr enum_t MAX_PUB_SIG = QP::Q_USER_SIG + 10;
+constexpr enum_t SIG_A       = QP::Q_USER_SIG + 1;
+constexpr size_t SMALL_EVENTS = 2;
+
+struct LargeEvent : public QP::QEvt {
+    std::array<uint64_t, 4> payload;
+};
+
+}   // namespace
+
+TEST_GROUP(qf_ctrlPoolOverflowTests)
+{
+    std::vector<QP::QEvt const*> mHeld;
+    DefaultDummyActiveObjectUniquePtr mDummy;
+
+    void setup() final
+    {
+        qf_ctrl::Setup(MAX_PUB_SIG, 100,
+                       {{sizeof(uint64_t) * 2, SMALL_EVENTS},
+                        {sizeof(LargeEvent), 1}});
+        overflow::Enable();
+    }
+
+    void teardown() final
+    {
+        Release();
+        mHeld.shrink_to_fit();
+        qf_ctrl::Teardown();
+        mDummy.reset();
+    }
+
+    void Hold(size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            mHeld.push_back(Q_NEW(QP::QEvt, SIG_A));
+        }
+    }
+
+    void Release()
+    {
+        for (auto e : mHeld) {
+            QP::QF::gc(e);
+        }
+        mHeld.clear();
+    }
+};
+
+TEST(qf_ctrlPoolOverflowTests, a_pool_within_its_size_does_not_overflow)
+{
+    Hold(SMALL_EVENTS);
+    CHECK_EQUAL(0U, overflow::GetStats(0).overflows);
+    CHECK_EQUAL(SMALL_EVENTS, qf_ctrl::PoolEventsInUse());
+}
+
+TEST(qf_ctrlPoolOverflowTests, an_exhausted_pool_overflows_rather_than_asserting)
+{
+    Hold(SMALL_EVENTS + 3);
+
+    const auto stats = overflow::GetStats(0);
+    CHECK_EQUAL(3U, stats.overflows);
+    CHECK_EQUAL(3U, stats.liveBlocks);
+    CHECK_EQUAL(3U, stats.peakBlocks);
+    CHECK_EQUAL(sizeof(uint64_t) * 2, stats.blockSize);
+    CHECK_EQUAL(3U, overflow::LiveBlocks());
+    CHECK_EQUAL(SMALL_EVENTS + 3, qf_ctrl::PoolEventsInUse());
+    CHECK_EQUAL(0U, overflow::GetStats(1).overflows);
+}
+
+TEST(qf_ctrlPoolOverflowTests, gc_returns_each_event_to_its_allocator)
+{
+    Hold(SMALL_EVENTS + 3);
+    Release();
+    CHECK_EQUAL(0U, overflow::LiveBlocks());
+    CHECK_EQUAL(0U, qf_ctrl::PoolEventsInUse());
+
+    // the pool supplies its own events again
+    Hold(SMALL_EVENTS);
+    CHECK_EQUAL(3U, overflow::GetStats(0).overflows);
+}
+
+TEST(qf_ctrlPoolOverflowTests, peak_extra_demand_is_the_most_overflow_events_in_use)
+{
+    Hold(SMALL_EVENTS + 4);
+    QP::QF::gc(mHeld.back());
+    mHeld.pop_back();
+    QP::QF::gc(mHeld.back());
+    mHeld.pop_back();
+    Hold(1);
+
+    const auto stats = overflow::GetStats(0);
+    CHECK_EQUAL(5U, stats.overflows);
+    CHECK_EQUAL(3U, stats.liveBlocks);
+    CHECK_EQUAL(4U, stats.peakBlocks);
+}
+
+TEST(qf_ctrlPoolOverflowTests, events_processed_by_an_active_object_are_recycled)
+{
+    mDummy = CreateAndStartDummyActiveObject();
+    for (size_t i = 0; i < SMALL_EVENTS + 2; ++i) {
+        mDummy->POST(Q_NEW(QP::QEvt, SIG_A), 0);
+    }
+    CHECK_EQUAL(2U, overflow::LiveBlocks());
+
+    qf_ctrl::ProcessEvents();
+    CHECK_EQUAL(0U, overflow::LiveBlocks());
+    CHECK_EQUAL(0U, qf_ctrl::PoolEventsInUse());
+}
+
+TEST(qf_ctrlPoolOverflowTests, report_lists_each_overflowing_pool)
+{
+    Hold(SMALL_EVENTS + 2);
+    CHECK_TRUE(ReportContains(&overflow::Report,
+                              "Pool 0 (16 byte events) overflowed 2 times"));
+    CHECK_TRUE(ReportContains(&overflow::Report,
+                              "peak extra demand 2 events (32 bytes)"));
+}
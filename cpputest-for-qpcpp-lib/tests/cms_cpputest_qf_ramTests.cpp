@@ -0,0 +1,106 @@
+/// @brief Tests for the RAM footprint report.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_ram.hpp"
+#include "cmsDummyActiveObject.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <cstdio>
+#include "cmsTestReportText.hpp"
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+
+namespace {
+
+constexpr enum_t MAX_PUB_SIG = QP::Q_USER_SIG + 10;
+
+}   // namespace
+
+TEST_GROUP(qf_ctrlRamTests)
+{
+    cms::test::DefaultDummyActiveObject* mDummy = nullptr;
+
+    void setup() final
+    {
+        qf_ctrl::Setup(MAX_PUB_SIG, 100,
+                       {{sizeof(uint64_t) * 2, 10}, {sizeof(uint64_t) * 8, 4}});
+    }
+
+    void teardown() final
+    {
+        qf_ctrl::Teardown();
+        delete mDummy;
+    }
+
+    void StartDummy()
+    {
+        mDummy = new cms::test::DefaultDummyActiveObject();
+        mDummy->dummyStart();
+    }
+};
+
+TEST(qf_ctrlRamTests, accounts_for_pools_and_subscriber_lists)
+{
+    const auto footprint = ram::Measure();
+    CHECK_EQUAL(16U * 10U + 64U * 4U, footprint.poolBytes);
+    CHECK_EQUAL(static_cast<size_t>(MAX_PUB_SIG) * sizeof(QP::QSubscrList),
+                footprint.subscriberBytes);
+    CHECK_TRUE(footprint.frameworkBytes > 0U);
+    CHECK_EQUAL(0U, footprint.activeObjects);
+    CHECK_EQUAL(footprint.poolBytes + footprint.subscriberBytes +
+                  footprint.frameworkBytes,
+                footprint.Total());
+}
+
+TEST(qf_ctrlRamTests, accounts_for_started_active_objects)
+{
+    StartDummy();
+    auto footprint = ram::Measure();
+    CHECK_EQUAL(1U, footprint.activeObjects);
+    CHECK_EQUAL(50U * sizeof(QP::QEvt const*), footprint.queueBytes);
+    CHECK_EQUAL(1U, footprint.undeclaredActiveObjects);
+    CHECK_EQUAL(0U, footprint.activeObjectBytes);
+
+    ram::DeclareActiveObject(mDummy);
+    footprint = ram::Measure();
+    CHECK_EQUAL(0U, footprint.undeclaredActiveObjects);
+    CHECK_EQUAL(sizeof(cms::test::DefaultDummyActiveObject),
+                footprint.activeObjectBytes);
+}
+
+TEST(qf_ctrlRamTests, teardown_records_the_test_for_the_reports)
+{
+    StartDummy();
+    qf_ctrl::Teardown();
+
+    CHECK_TRUE(ReportContains(&ram::ReportText,
+                              "teardown_records_the_test_for_the_reports: total"));
+    CHECK_TRUE(ReportContains(&ram::ReportJson,
+                              "\"name\": \"teardown_records_the_test_for_the_reports\""));
+    CHECK_TRUE(ReportContains(&ram::ReportText, "suite largest of"));
+
+    qf_ctrl::Setup(MAX_PUB_SIG, 100);
+}
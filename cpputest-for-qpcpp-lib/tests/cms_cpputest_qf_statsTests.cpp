@@ -0,0 +1,155 @@
+/// @brief Tests for the runtime statistics of the fake QF port.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_stats.hpp"
+#include "cmsDummyActiveObject.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <chrono>
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr enum_t MAX_PUB_SIG = QP::Q_USER_SIG + 10;
+constexpr enum_t SIG_A       = QP::Q_USER_SIG + 1;
+
+}   // namespace
+
+TEST_GROUP(qf_ctrlStatsTests)
+{
+    DefaultDummyActiveObjectUniquePtr mDummyA;
+    DefaultDummyActiveObjectUniquePtr mDummyB;
+
+    void setup() final
+    {
+        qf_ctrl::Setup(MAX_PUB_SIG, 1000);
+        mDummyA = CreateAndStartDummyActiveObject(
+          DefaultDummyActiveObject::EventBehavior::CALLBACK,
+          qf_ctrl::DUMMY_AO_A_PRIORITY);
+        mDummyB = CreateAndStartDummyActiveObject(
+          DefaultDummyActiveObject::EventBehavior::CALLBACK,
+          qf_ctrl::DUMMY_AO_B_PRIORITY);
+        mDummyA->subscribe(SIG_A);
+        mDummyB->subscribe(SIG_A);
+    }
+
+    void teardown() final
+    {
+        qf_ctrl::Teardown();
+        mDummyA.reset();
+        mDummyB.reset();
+    }
+
+    void PublishAndPost()
+    {
+        qf_ctrl::PublishEvent(SIG_A);
+        mDummyA->POST(Q_NEW(QP::QEvt, SIG_A), nullptr);
+        qf_ctrl::ProcessEvents();
+    }
+};
+
+TEST(qf_ctrlStatsTests, counts_publishes_deliveries_posts_and_dispatches)
+{
+    if (!qf_ctrl::StatsEnabled()) {
+        return;
+    }
+
+    PublishAndPost();
+
+    const auto stats = qf_ctrl::GetStats();
+    CHECK_EQUAL(1U, stats.publishes);
+    CHECK_EQUAL(2U, stats.deliveries);
+    CHECK_EQUAL(1U, stats.posts);
+    CHECK_EQUAL(2U, stats.dispatched[qf_ctrl::DUMMY_AO_A_PRIORITY]);
+    CHECK_EQUAL(1U, stats.dispatched[qf_ctrl::DUMMY_AO_B_PRIORITY]);
+    CHECK_EQUAL(3U, stats.TotalDispatched());
+    CHECK_TRUE(stats.schedulerPasses >= 2U);
+}
+
+TEST(qf_ctrlStatsTests, counts_allocations_and_frees_per_pool)
+{
+    if (!qf_ctrl::StatsEnabled()) {
+        return;
+    }
+
+    PublishAndPost();
+
+    const auto stats = qf_ctrl::GetStats();
+    CHECK_EQUAL(2U, stats.allocations[0]);
+    CHECK_EQUAL(2U, stats.frees[0]);
+    CHECK_EQUAL(0U, stats.allocations[1]);
+}
+
+TEST(qf_ctrlStatsTests, counts_ticks)
+{
+    if (!qf_ctrl::StatsEnabled()) {
+        return;
+    }
+
+    qf_ctrl::MoveTimeForward(25ms);
+    CHECK_EQUAL(25U, qf_ctrl::GetStats().ticks);
+}
+
+TEST(qf_ctrlStatsTests, reset_clears_every_counter)
+{
+    PublishAndPost();
+    qf_ctrl::MoveTimeForward(5ms);
+    qf_ctrl::ResetStats();
+
+    const auto stats = qf_ctrl::GetStats();
+    CHECK_EQUAL(0U, stats.publishes);
+    CHECK_EQUAL(0U, stats.posts);
+    CHECK_EQUAL(0U, stats.TotalDispatched());
+    CHECK_EQUAL(0U, stats.allocations[0]);
+    CHECK_EQUAL(0U, stats.ticks);
+    CHECK_EQUAL(0U, stats.schedulerPasses);
+}
+
+TEST(qf_ctrlStatsTests, counters_stay_zero_unless_enabled)
+{
+    if (qf_ctrl::StatsEnabled()) {
+        return;
+    }
+
+    PublishAndPost();
+    qf_ctrl::MoveTimeForward(5ms);
+
+    const auto stats = qf_ctrl::GetStats();
+    CHECK_EQUAL(0U, stats.publishes);
+    CHECK_EQUAL(0U, stats.TotalDispatched());
+    CHECK_EQUAL(0U, stats.ticks);
+}
+
+TEST(qf_ctrlStatsTests, setup_restarts_the_counters)
+{
+    PublishAndPost();
+    qf_ctrl::Teardown();
+    qf_ctrl::Setup(MAX_PUB_SIG, 1000);
+
+    CHECK_EQUAL(0U, qf_ctrl::GetStats().TotalDispatched());
+}
@@ -0,0 +1,301 @@
+/// @brief Tests for the Dynamic Orthogonal Container class.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cmsOrthogonalComponent.hpp"
+#include "cmsDynamicOrthogonalContainer.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include <array>
+#include <memory>
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+using namespace cms;
+using namespace cms::test;
+
+enum InternalTestSigs {
+    FEATURE_A_POST_SIG = QP::Q_USER_SIG + 1,
+    FEATURE_B_POST_SIG,
+    FEATURE_B_PUBLISH_SIG,
+    TEST_MAX_SIG,
+
+    // a post only signal beyond the container's signal routing table
+    FEATURE_UNROUTED_POST_SIG = CMS_ORTHOGONAL_ROUTED_SIGNALS + 1
+};
+
+namespace {
+
+// A component whose signals and mock name are chosen at run time,
+// as a product configuration would choose its features.
+class FeatureComponent : public OrthogonalComponent {
+public:
+    static int destructions;
+
+    FeatureComponent(QP::QActive* container, const char* mockName,
+                     enum_t postSig, enum_t publishSig = 0,
+                     bool isFirstMatch = false) :
+        OrthogonalComponent(container, Q_STATE_CAST(initial)),
+        m_mockName(mockName), m_postSig(postSig), m_publishSig(publishSig),
+        m_isFirstMatch(isFirstMatch)
+    {
+    }
+
+    ~FeatureComponent() override { ++destructions; }
+
+protected:
+    void subscribe() override
+    {
+        if (m_publishSig != 0) {
+            m_container->subscribe(m_publishSig);
+        }
+        mock(m_mockName).actualCall("subscribe");
+    }
+
+    bool isSignalDesired(enum_t sig) const override
+    {
+        return (sig == m_postSig)
+               || ((m_publishSig != 0) && (sig == m_publishSig));
+    }
+
+    bool isSignalConsumed(enum_t) const override { return m_isFirstMatch; }
+
+    static QP::QState initial(FeatureComponent* const me,
+                              QP::QEvt const* const)
+    {
+        return me->tran(Q_STATE_CAST(&running));
+    }
+
+    static QP::QState running(FeatureComponent* const me,
+                              QP::QEvt const* const e)
+    {
+        QP::QState rtn;
+        switch (e->sig) {
+            case Q_ENTRY_SIG:
+                mock(me->m_mockName).actualCall("running-entry");
+                rtn = Q_HANDLED();
+                break;
+            case Q_EXIT_SIG:
+                rtn = Q_HANDLED();
+                break;
+            default:
+                if (me->isSignalDesired(e->sig)) {
+                    mock(me->m_mockName)
+                      .actualCall("running-desired")
+                      .withParameter("sig", static_cast<int>(e->sig));
+                    rtn = Q_HANDLED();
+                }
+                else {
+                    rtn = me->super(&top);
+                }
+                break;
+        }
+        return rtn;
+    }
+
+private:
+    const char* m_mockName;
+    enum_t m_postSig;
+    enum_t m_publishSig;
+    bool m_isFirstMatch;
+};
+
+int FeatureComponent::destructions = 0;
+
+constexpr const char* FEATURE_A = "FeatureA";
+constexpr const char* FEATURE_B = "FeatureB";
+
+struct ProductConfig {
+    bool hasFeatureA;
+    bool hasFeatureB;
+};
+
+using UnderTestContainer = DynamicOrthogonalContainer<4, 512>;
+
+}   // namespace
+
+TEST_GROUP(DynamicOrthogonalContainerTests)
+{
+    std::array<const QP::QEvt*, 20> eventStorage {};
+
+    void setup() final
+    {
+        eventStorage.fill(nullptr);
+        qf_ctrl::Setup(TEST_MAX_SIG, 100);
+        FeatureComponent::destructions = 0;
+    }
+
+    void teardown() final
+    {
+        mock().clear();
+        cms::test::qf_ctrl::Teardown();
+    }
+
+    static std::unique_ptr<UnderTestContainer>
+    CreateForConfig(const ProductConfig& config)
+    {
+        return std::unique_ptr<UnderTestContainer>(
+          new UnderTestContainer([&config](UnderTestContainer& container) {
+              if (config.hasFeatureA) {
+                  container.addComponent<FeatureComponent>(
+                    FEATURE_A, FEATURE_A_POST_SIG);
+              }
+              if (config.hasFeatureB) {
+                  container.addComponent<FeatureComponent>(
+                    FEATURE_B, FEATURE_B_POST_SIG, FEATURE_B_PUBLISH_SIG);
+              }
+          }));
+    }
+
+    void Start(UnderTestContainer& container)
+    {
+        mock().ignoreOtherCalls();
+        container.start(1, eventStorage.data(), eventStorage.size(), nullptr,
+                        0);
+        mock().clear();
+    }
+};
+
+TEST(DynamicOrthogonalContainerTests,
+     components_are_registered_at_construction_per_configuration)
+{
+    auto both  = CreateForConfig(ProductConfig {true, true});
+    auto onlyB  = CreateForConfig(ProductConfig {false, true});
+    CHECK_EQUAL(2U, both->componentCount());
+    CHECK_EQUAL(1U, onlyB->componentCount());
+    CHECK_TRUE(both->arenaBytesUsed() >= 2 * sizeof(FeatureComponent));
+}
+
+TEST(DynamicOrthogonalContainerTests,
+     start_will_subscribe_and_start_components_in_registration_order)
+{
+    auto underTest = CreateForConfig(ProductConfig {true, true});
+
+    mock().strictOrder();
+    mock(FEATURE_A).expectOneCall("subscribe");
+    mock(FEATURE_A).expectOneCall("running-entry");
+    mock(FEATURE_B).expectOneCall("subscribe");
+    mock(FEATURE_B).expectOneCall("running-entry");
+    underTest->start(1, eventStorage.data(), eventStorage.size(), nullptr, 0);
+    mock().checkExpectations();
+}
+
+TEST(DynamicOrthogonalContainerTests,
+     posted_and_published_events_reach_only_the_interested_component)
+{
+    static const QP::QEvt postA = QP::QEvt(FEATURE_A_POST_SIG);
+
+    auto underTest = CreateForConfig(ProductConfig {true, true});
+    Start(*underTest);
+
+    mock(FEATURE_A)
+      .expectOneCall("running-desired")
+      .withParameter("sig", FEATURE_A_POST_SIG);
+    qf_ctrl::PostAndProcess(&postA, underTest.get());
+    mock().checkExpectations();
+
+    mock(FEATURE_B)
+      .expectOneCall("running-desired")
+      .withParameter("sig", FEATURE_B_PUBLISH_SIG);
+    qf_ctrl::PublishAndProcess(FEATURE_B_PUBLISH_SIG);
+    mock().checkExpectations();
+}
+
+TEST(DynamicOrthogonalContainerTests,
+     first_match_component_consumes_signal_before_later_components)
+{
+    static const QP::QEvt postA = QP::QEvt(FEATURE_A_POST_SIG);
+
+    auto underTest = std::unique_ptr<UnderTestContainer>(
+      new UnderTestContainer([](UnderTestContainer& container) {
+          container.addComponent<FeatureComponent>(
+            FEATURE_A, FEATURE_A_POST_SIG, 0, true);
+          container.addComponent<FeatureComponent>(FEATURE_B,
+                                                   FEATURE_A_POST_SIG);
+      }));
+    Start(*underTest);
+
+    mock(FEATURE_A)
+      .expectOneCall("running-desired")
+      .withParameter("sig", FEATURE_A_POST_SIG);
+    qf_ctrl::PostAndProcess(&postA, underTest.get());
+    mock().checkExpectations();
+}
+
+TEST(DynamicOrthogonalContainerTests,
+     signal_beyond_the_routing_table_still_reaches_interested_component)
+{
+    static const QP::QEvt unrouted = QP::QEvt(FEATURE_UNROUTED_POST_SIG);
+
+    auto underTest = std::unique_ptr<UnderTestContainer>(
+      new UnderTestContainer([](UnderTestContainer& container) {
+          container.addComponent<FeatureComponent>(FEATURE_A,
+                                                   FEATURE_UNROUTED_POST_SIG);
+      }));
+    Start(*underTest);
+
+    mock(FEATURE_A)
+      .expectOneCall("running-desired")
+      .withParameter("sig", FEATURE_UNROUTED_POST_SIG);
+    qf_ctrl::PostAndProcess(&unrouted, underTest.get());
+    mock().checkExpectations();
+}
+
+TEST(DynamicOrthogonalContainerTests,
+     destroying_the_container_destroys_each_component)
+{
+    auto underTest = CreateForConfig(ProductConfig {true, true});
+    underTest.reset();
+    CHECK_EQUAL(2, FeatureComponent::destructions);
+}
+
+TEST(DynamicOrthogonalContainerTests,
+     add_component_beyond_max_components_returns_null)
+{
+    DynamicOrthogonalContainer<1, 512> underTest;
+    CHECK_TRUE(underTest.addComponent<FeatureComponent>(
+                 FEATURE_A, FEATURE_A_POST_SIG) != nullptr);
+    POINTERS_EQUAL(nullptr, underTest.addComponent<FeatureComponent>(
+                              FEATURE_B, FEATURE_B_POST_SIG));
+    CHECK_EQUAL(1U, underTest.componentCount());
+}
+
+TEST(DynamicOrthogonalContainerTests,
+     add_component_beyond_the_arena_returns_null)
+{
+    DynamicOrthogonalContainer<4, sizeof(FeatureComponent)> underTest;
+    CHECK_TRUE(underTest.addComponent<FeatureComponent>(
+                 FEATURE_A, FEATURE_A_POST_SIG) != nullptr);
+    POINTERS_EQUAL(nullptr, underTest.addComponent<FeatureComponent>(
+                              FEATURE_B, FEATURE_B_POST_SIG));
+    CHECK_EQUAL(1U, underTest.componentCount());
+    CHECK_EQUAL(sizeof(FeatureComponent), underTest.arenaBytesUsed());
+}
+
+TEST(DynamicOrthogonalContainerTests,
+     add_component_after_start_returns_null)
+{
+    auto underTest = CreateForConfig(ProductConfig {true, false});
+    Start(*underTest);
+    POINTERS_EQUAL(nullptr, underTest->addComponent<FeatureComponent>(
+                              FEATURE_B, FEATURE_B_POST_SIG));
+    CHECK_EQUAL(1U, underTest->componentCount());
+}
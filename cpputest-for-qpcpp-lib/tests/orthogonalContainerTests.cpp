@@ -25,6 +25,7 @@
 #include "cmsOrthogonalContainer.hpp"
 #include "cms_cpputest_qf_ctrl.hpp"
 #include <memory>
+#include <type_traits>
 #include "CppUTest/TestHarness.h"
 #include "CppUTestExt/MockSupport.h"
 
@@ -38,7 +39,10 @@ enum InternalTestSigs {
     TEST2_POST_SIG,
     TEST1_TIMER_SIG,
     TEST2_TIMER_SIG,
-    TEST_MAX_SIG
+    TEST_MAX_SIG,
+
+    // a post only signal beyond the container's signal routing table
+    TEST_UNROUTED_POST_SIG = CMS_ORTHOGONAL_ROUTED_SIGNALS + 1
 };
 
 // since the orthogonal component is a pure virtual base
@@ -72,15 +76,6 @@ public:
     {
     }
 
-    // Due to the way the Container creates the desired
-    // Components, a properly functioning move
-    // constructor is required from any concrete
-    // Component
-    TestComponent(TestComponent&& other) noexcept :
-        OrthogonalComponent(std::move(other)), m_poll(m_container, TimerSig)
-    {
-    }
-
 protected:
     void subscribe() override
     {
@@ -143,6 +138,10 @@ protected:
                 mock(MockName).actualCall("running-TEST2_TIMER_SIG");
                 rtn = Q_HANDLED();
                 break;
+            case TEST_UNROUTED_POST_SIG:
+                mock(MockName).actualCall("running-TEST_UNROUTED_POST_SIG");
+                rtn = Q_HANDLED();
+                break;
             default:
                 rtn = me->super(&top);
                 break;
@@ -151,6 +150,58 @@ protected:
     }
 };
 
+// A test component opting into first-match semantics for
+// each signal it desires.
+template <enum_t SubscribeSig, enum_t PostSig, enum_t TimerSig,
+          uint32_t TimerIntervalTicks, const char* MockName>
+class FirstMatchTestComponent
+    : public TestComponent<SubscribeSig, PostSig, TimerSig, TimerIntervalTicks,
+                           MockName> {
+public:
+    using TestComponent<SubscribeSig, PostSig, TimerSig, TimerIntervalTicks,
+                        MockName>::TestComponent;
+
+protected:
+    bool isSignalConsumed(enum_t sig) const override
+    {
+        return this->isSignalDesired(sig);
+    }
+};
+
+// Counts constructions, confirming the container builds each
+// component exactly once, in place.
+class ConstructionCountingComponent : public OrthogonalComponent {
+public:
+    static int constructions;
+
+    explicit ConstructionCountingComponent(QP::QActive* container) :
+        OrthogonalComponent(container, Q_STATE_CAST(initial))
+    {
+        ++constructions;
+    }
+
+    ConstructionCountingComponent(ConstructionCountingComponent&&) = delete;
+
+protected:
+    void subscribe() override { }
+
+    bool isSignalDesired(enum_t) const override { return false; }
+
+    static QP::QState initial(ConstructionCountingComponent* const me,
+                              QP::QEvt const* const)
+    {
+        return me->tran(Q_STATE_CAST(&running));
+    }
+
+    static QP::QState running(ConstructionCountingComponent* const me,
+                              QP::QEvt const* const)
+    {
+        return me->super(&top);
+    }
+};
+
+int ConstructionCountingComponent::constructions = 0;
+
 }   // namespace
 
 using ComponentOne =
@@ -160,6 +211,17 @@ using ComponentTwo =
   TestComponent<TEST2_PUBLISH_SIG, TEST2_POST_SIG, TEST2_TIMER_SIG,
                 TICKS_PER_SECOND * 3, MockNames::CompTwo>;
 
+// shares component one's signals, but reports as component two
+using SharedTest1ComponentTwo =
+  TestComponent<TEST1_PUBLISH_SIG, TEST1_POST_SIG, TEST1_TIMER_SIG,
+                TICKS_PER_SECOND * 3, MockNames::CompTwo>;
+using FirstMatchComponentOne =
+  FirstMatchTestComponent<TEST1_PUBLISH_SIG, TEST1_POST_SIG, TEST1_TIMER_SIG,
+                          TICKS_PER_SECOND * 2, MockNames::CompOne>;
+using UnroutedComponentTwo =
+  TestComponent<TEST2_PUBLISH_SIG, TEST_UNROUTED_POST_SIG, TEST2_TIMER_SIG,
+                TICKS_PER_SECOND * 3, MockNames::CompTwo>;
+
 TEST_GROUP(OrthogonalContainerTests)
 {
 
@@ -177,21 +239,29 @@ TEST_GROUP(OrthogonalContainerTests)
         cms::test::qf_ctrl::Teardown();
     }
 
-    std::unique_ptr<QP::QActive> CreateAndStartWithTwoTestComponents()
+    // ContainerT must hold a component reporting as CompOne
+    // followed by a component reporting as CompTwo.
+    template <class ContainerT>
+    std::unique_ptr<QP::QActive> CreateAndStartOneAndTwoContainer()
     {
         mock().strictOrder();
         mock(MockNames::CompOne).expectOneCall("subscribe");
         mock(MockNames::CompOne).expectOneCall("running-entry");
         mock(MockNames::CompTwo).expectOneCall("subscribe");
         mock(MockNames::CompTwo).expectOneCall("running-entry");
-        auto underTest = std::unique_ptr<QP::QActive>(
-          new OrthogonalContainer<ComponentOne, ComponentTwo>());
+        auto underTest = std::unique_ptr<QP::QActive>(new ContainerT());
         underTest->start(1, eventStorage.data(), eventStorage.size(), nullptr,
                          0);
         mock().checkExpectations();
         return underTest;
     }
 
+    std::unique_ptr<QP::QActive> CreateAndStartWithTwoTestComponents()
+    {
+        return CreateAndStartOneAndTwoContainer<
+          OrthogonalContainer<ComponentOne, ComponentTwo>>();
+    }
+
     static QP::QActive* StartAStaticallyAllocatedContainer()
     {
         static std::array<const QP::QEvt*, 20> staticStorage {};
@@ -317,3 +387,59 @@ TEST(
 
     mock().checkExpectations();
 }
+
+TEST(OrthogonalContainerTests,
+     container_routes_a_shared_signal_to_each_interested_component_in_order)
+{
+    static const QP::QEvt Test1Event = QP::QEvt(TEST1_POST_SIG);
+
+    auto underTest = CreateAndStartOneAndTwoContainer<
+      OrthogonalContainer<ComponentOne, SharedTest1ComponentTwo>>();
+
+    mock(MockNames::CompOne).expectOneCall("running-TEST1_POST_SIG");
+    mock(MockNames::CompTwo).expectOneCall("running-TEST1_POST_SIG");
+    qf_ctrl::PostAndProcess(&Test1Event, underTest.get());
+    mock().checkExpectations();
+}
+
+TEST(OrthogonalContainerTests,
+     first_match_component_consumes_signal_before_later_components)
+{
+    static const QP::QEvt Test1Event = QP::QEvt(TEST1_POST_SIG);
+
+    auto underTest = CreateAndStartOneAndTwoContainer<
+      OrthogonalContainer<FirstMatchComponentOne, SharedTest1ComponentTwo>>();
+
+    mock(MockNames::CompOne).expectOneCall("running-TEST1_POST_SIG");
+    mock(MockNames::CompTwo).expectNoCall("running-TEST1_POST_SIG");
+    qf_ctrl::PostAndProcess(&Test1Event, underTest.get());
+    mock().checkExpectations();
+}
+
+TEST(OrthogonalContainerTests,
+     signal_beyond_the_routing_table_still_reaches_interested_component)
+{
+    static const QP::QEvt UnroutedEvent = QP::QEvt(TEST_UNROUTED_POST_SIG);
+
+    auto underTest = CreateAndStartOneAndTwoContainer<
+      OrthogonalContainer<ComponentOne, UnroutedComponentTwo>>();
+
+    mock(MockNames::CompOne).expectNoCall("running-TEST_UNROUTED_POST_SIG");
+    mock(MockNames::CompTwo).expectOneCall("running-TEST_UNROUTED_POST_SIG");
+    qf_ctrl::PostAndProcess(&UnroutedEvent, underTest.get());
+    mock().checkExpectations();
+}
+
+TEST(OrthogonalContainerTests,
+     container_constructs_each_component_once_without_moving_it)
+{
+    static_assert(
+      !std::is_move_constructible<ConstructionCountingComponent>::value,
+      "test component is expected to be immovable");
+
+    ConstructionCountingComponent::constructions = 0;
+    auto underTest = std::unique_ptr<QP::QActive>(
+      new OrthogonalContainer<ConstructionCountingComponent, ComponentOne,
+                              ConstructionCountingComponent>());
+    CHECK_EQUAL(2, ConstructionCountingComponent::constructions);
+}
@@ -0,0 +1,245 @@
+/// @brief Tests for PublishedEventExpectations.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cmsTestPublishedEventExpectations.hpp"
+#include "cmsTestPublishedEventRecorder.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <chrono>
+#include <cstring>
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+#include "CppUTest/TestTestingFixture.h"
+
+using namespace cms::test;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr enum_t SIG_A       = QP::Q_USER_SIG + 1;
+constexpr enum_t SIG_B       = QP::Q_USER_SIG + 2;
+constexpr enum_t SIG_C       = QP::Q_USER_SIG + 3;
+constexpr enum_t SIG_OTHER   = QP::Q_USER_SIG + 4;
+constexpr enum_t MAX_PUB_SIG = QP::Q_USER_SIG + 10;
+
+struct ValueEvent : QP::QEvt {
+    int value;
+};
+
+bool IsPositive(QP::QEvt const* e)
+{
+    return static_cast<ValueEvent const*>(e)->value > 0;
+}
+
+// run by a TestTestingFixture, publishing SIG_B before the SIG_A expected
+void PublishOutOfOrder()
+{
+    qf_ctrl::PublishAndProcess(SIG_B);
+}
+
+}   // namespace
+
+TEST_GROUP(PublishedEventExpectationsTests)
+{
+    PublishedEventRecorder* mRecorder = nullptr;
+    PublishedEventExpectations mExpect {false};
+
+    void setup() final
+    {
+        qf_ctrl::Setup(MAX_PUB_SIG, 1000);
+        mRecorder = new PublishedEventRecorder(SIG_A, MAX_PUB_SIG);
+        mRecorder->recorderStart(qf_ctrl::RECORDER_PRIORITY);
+        mRecorder->streamTo(&mExpect);
+    }
+
+    void teardown() final
+    {
+        qf_ctrl::Teardown();
+        delete mRecorder;
+    }
+
+    static void PublishValue(enum_t sig, int value)
+    {
+        auto e   = Q_NEW(ValueEvent, sig);
+        e->value = value;
+        qf_ctrl::PublishAndProcess(e);
+    }
+
+    void CheckFailure(const char* expected) const
+    {
+        CHECK_TRUE(mExpect.hasFailed());
+        CHECK_TEXT(std::strstr(mExpect.failure(), expected) != nullptr,
+                   mExpect.failure());
+    }
+};
+
+TEST(PublishedEventExpectationsTests, an_ordered_sequence_is_met)
+{
+    mExpect.inOrder({SIG_A, {SIG_B, &IsPositive}, SIG_C});
+
+    qf_ctrl::PublishAndProcess(SIG_A);
+    qf_ctrl::PublishAndProcess(SIG_OTHER);
+    PublishValue(SIG_B, 3);
+    qf_ctrl::PublishAndProcess(SIG_C);
+
+    // a completed sequence ignores its signals
+    qf_ctrl::PublishAndProcess(SIG_A);
+
+    CHECK_FALSE(mExpect.hasFailed());
+    STRCMP_EQUAL("", mExpect.failure());
+    mExpect.verify();
+}
+
+TEST(PublishedEventExpectationsTests, events_are_matched_rather_than_recorded)
+{
+    mExpect.countWithin(SIG_A, 0U, 1000U, 1s);
+    for (int i = 0; i < 100; ++i) {
+        qf_ctrl::PublishAndProcess(SIG_A);
+    }
+
+    CHECK_FALSE(mRecorder->isAnyEventRecorded());
+    CHECK_EQUAL(0U, qf_ctrl::PoolEventsInUse());
+    CHECK_EQUAL(100U, mExpect.eventCount());
+}
+
+TEST(PublishedEventExpectationsTests, an_ordered_sequence_fails_out_of_order)
+{
+    mExpect.inOrder({SIG_A, SIG_B});
+
+    qf_ctrl::MoveTimeForward(5ms);
+    qf_ctrl::PublishAndProcess(SIG_B);
+
+    CheckFailure("published event #1");
+    CheckFailure("at 5 ms");
+    CheckFailure("expectation 1 (in order): expected step 1");
+}
+
+TEST(PublishedEventExpectationsTests, a_step_fails_on_its_payload)
+{
+    mExpect.inOrder({SIG_A, {SIG_B, &IsPositive}});
+
+    qf_ctrl::PublishAndProcess(SIG_A);
+    PublishValue(SIG_B, -1);
+
+    CheckFailure("published event #2");
+    CheckFailure("step 2 payload did not match");
+}
+
+TEST(PublishedEventExpectationsTests, matching_stops_at_the_first_failure)
+{
+    mExpect.inOrder({SIG_A}).always(SIG_B, &IsPositive);
+
+    PublishValue(SIG_B, -1);
+    PublishValue(SIG_B, -2);
+    qf_ctrl::PublishAndProcess(SIG_C);
+
+    CHECK_EQUAL(1U, mExpect.eventCount());
+    CheckFailure("expectation 2 (always): payload did not match");
+}
+
+TEST(PublishedEventExpectationsTests, unordered_steps_are_met_in_any_order)
+{
+    mExpect.unordered({SIG_A, SIG_B, {SIG_C, &IsPositive}}, 100ms);
+
+    qf_ctrl::MoveTimeForward(1s);
+    PublishValue(SIG_C, 1);
+    qf_ctrl::MoveTimeForward(50ms);
+    qf_ctrl::PublishAndProcess(SIG_A);
+    qf_ctrl::PublishAndProcess(SIG_A);   // a repeat is ignored
+    qf_ctrl::MoveTimeForward(50ms);
+    qf_ctrl::PublishAndProcess(SIG_B);
+
+    CHECK_FALSE(mExpect.hasFailed());
+    mExpect.verify();
+}
+
+TEST(PublishedEventExpectationsTests, unordered_steps_fail_outside_their_window)
+{
+    mExpect.unordered({SIG_A, SIG_B}, 100ms);
+
+    qf_ctrl::PublishAndProcess(SIG_A);
+    qf_ctrl::MoveTimeForward(101ms);
+    qf_ctrl::PublishAndProcess(SIG_B);
+
+    CheckFailure("1 of 2 steps seen in the 100 ms window");
+}
+
+TEST(PublishedEventExpectationsTests, a_count_within_its_period_is_met)
+{
+    mExpect.countWithin(SIG_A, 2U, 3U, 100ms);
+
+    qf_ctrl::PublishAndProcess(SIG_A);
+    qf_ctrl::PublishAndProcess(SIG_A);
+    qf_ctrl::MoveTimeForward(200ms);
+
+    // after the period, events are no longer counted
+    qf_ctrl::PublishAndProcess(SIG_A);
+    qf_ctrl::PublishAndProcess(SIG_A);
+
+    CHECK_FALSE(mExpect.hasFailed());
+    mExpect.verify();
+}
+
+TEST(PublishedEventExpectationsTests, a_count_fails_above_its_maximum)
+{
+    mExpect.countWithin(SIG_A, 0U, 2U, 100ms);
+
+    for (int i = 0; i < 3; ++i) {
+        qf_ctrl::PublishAndProcess(SIG_A);
+    }
+
+    CheckFailure("published event #3");
+    CheckFailure("seen more than 2 times in 100 ms");
+}
+
+TEST(PublishedEventExpectationsTests, a_count_fails_below_its_minimum_once_late)
+{
+    mExpect.countWithin(SIG_A, 2U, 5U, 100ms);
+
+    qf_ctrl::PublishAndProcess(SIG_A);
+    qf_ctrl::MoveTimeForward(150ms);
+    qf_ctrl::PublishAndProcess(SIG_OTHER);
+
+    CheckFailure("seen 1 times in 100 ms, expected at least 2");
+}
+
+TEST(PublishedEventExpectationsTests,
+     fail_fast_fails_the_test_once_the_dispatch_returns)
+{
+    PublishedEventExpectations failFast;
+    failFast.inOrder({SIG_A, SIG_B});
+    mRecorder->streamTo(&failFast);
+
+    TestTestingFixture fixture;
+    fixture.setTestFunction(&PublishOutOfOrder);
+    fixture.runAllTests();
+    mRecorder->streamTo(&mExpect);
+
+    CHECK_EQUAL(1U, fixture.getFailureCount());
+    fixture.assertPrintContains("failed expectation 1 (in order)");
+
+    // QF's dispatch completed, freeing the event
+    CHECK_EQUAL(0U, QP::GetActivePriority());
+    CHECK_EQUAL(0U, qf_ctrl::PoolEventsInUse());
+}
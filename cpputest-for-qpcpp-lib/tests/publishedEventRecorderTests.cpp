@@ -136,3 +136,87 @@ TEST(PublishedEventRecorderTests, can_record_custom_event)
     CHECK_EQUAL(TEST1_PUBLISH_SIG, event->sig);
     CHECK_EQUAL(5, event->testValue);
 }
+
+TEST(PublishedEventRecorderTests, recorder_counts_rather_than_records_counted_signals)
+{
+    using namespace std::chrono_literals;
+    mUnderTest->countSignals(TEST1_PUBLISH_SIG, TEST1_PUBLISH_SIG + 1);
+
+    qf_ctrl::PublishEvent(TEST1_PUBLISH_SIG);
+    qf_ctrl::MoveTimeForward(100ms);
+    qf_ctrl::PublishEvent(TEST1_PUBLISH_SIG);
+    qf_ctrl::MoveTimeForward(100ms);
+    qf_ctrl::PublishEvent(TEST1_PUBLISH_SIG);
+
+    // without a subscriber, each event returned to its pool at once
+    CHECK_EQUAL(0U, qf_ctrl::PoolEventsInUse());
+    qf_ctrl::ProcessEvents();
+    CHECK_FALSE(mUnderTest->isAnyEventRecorded());
+
+    const auto count = mUnderTest->getSignalCount(TEST1_PUBLISH_SIG);
+    CHECK_EQUAL(3U, count.count);
+    CHECK_EQUAL(200, count.lastSeen.count());
+
+    // signals not counted are recorded as before
+    ConfirmOneTrivialEventRecordingBehavior(TEST2_PUBLISH_SIG);
+    CHECK_EQUAL(0U, mUnderTest->getSignalCount(TEST2_PUBLISH_SIG).count);
+}
+
+TEST(PublishedEventRecorderTests, recorder_can_keep_the_last_counted_event)
+{
+    mUnderTest->countSignalsKeepingLast<TestEvent>(TEST2_PUBLISH_SIG,
+                                                   TEST2_PUBLISH_SIG + 1);
+    CHECK_TRUE(mUnderTest->getLastCountedEvent<TestEvent>(TEST2_PUBLISH_SIG) ==
+               nullptr);
+
+    for (int i = 1; i <= 1000; ++i) {
+        auto e       = Q_NEW(TestEvent, TEST2_PUBLISH_SIG);
+        e->testValue = i;
+        qf_ctrl::PublishEvent(e);
+    }
+
+    CHECK_EQUAL(1000U, mUnderTest->getSignalCount(TEST2_PUBLISH_SIG).count);
+    auto last = mUnderTest->getLastCountedEvent<TestEvent>(TEST2_PUBLISH_SIG);
+    CHECK_TRUE(last != nullptr);
+    CHECK_EQUAL(TEST2_PUBLISH_SIG, last->sig);
+    CHECK_EQUAL(1000, last->testValue);
+
+    mUnderTest->resetSignalCounts();
+    CHECK_EQUAL(0U, mUnderTest->getSignalCount(TEST2_PUBLISH_SIG).count);
+    CHECK_TRUE(mUnderTest->getLastCountedEvent<TestEvent>(TEST2_PUBLISH_SIG) ==
+               nullptr);
+}
+
+TEST(PublishedEventRecorderTests,
+     recorder_does_not_keep_a_last_counted_event_smaller_than_expected)
+{
+    static const QP::QEvt plain(TEST2_PUBLISH_SIG);
+    mUnderTest->countSignalsKeepingLast<TestEvent>(TEST2_PUBLISH_SIG,
+                                                   TEST2_PUBLISH_SIG + 1);
+
+    qf_ctrl::PublishEvent(&plain);
+    CHECK_EQUAL(1U, mUnderTest->getSignalCount(TEST2_PUBLISH_SIG).count);
+    CHECK_TRUE(mUnderTest->getLastCountedEvent<TestEvent>(TEST2_PUBLISH_SIG) ==
+               nullptr);
+
+    // the part copied is still kept
+    auto last = mUnderTest->getLastCountedEvent<QP::QEvt>(TEST2_PUBLISH_SIG);
+    CHECK_TRUE(last != nullptr);
+    CHECK_EQUAL(TEST2_PUBLISH_SIG, last->sig);
+}
+
+TEST(PublishedEventRecorderTests, recorder_may_count_signals_before_it_starts)
+{
+    auto recorder =
+      new PublishedEventRecorder(TEST1_PUBLISH_SIG, TEST2_PUBLISH_SIG + 1);
+    recorder->countSignals(TEST1_PUBLISH_SIG, TEST2_PUBLISH_SIG + 1);
+    recorder->recorderStart(2);
+
+    qf_ctrl::PublishAndProcess(TEST1_PUBLISH_SIG);
+    CHECK_FALSE(recorder->isAnyEventRecorded());
+    CHECK_EQUAL(1U, recorder->getSignalCount(TEST1_PUBLISH_SIG).count);
+
+    // the original recorder still subscribes and records
+    CHECK_TRUE(mUnderTest->isSignalRecorded(TEST1_PUBLISH_SIG));
+    delete recorder;
+}
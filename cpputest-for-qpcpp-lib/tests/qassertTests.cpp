@@ -24,6 +24,10 @@
 #include "CppUTest/TestHarness.h"
 #include "qp_port.hpp"
 #include "cmsQAssertMockSupport.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 
 Q_DEFINE_THIS_MODULE("QAssertTests");
 
@@ -55,3 +59,174 @@ TEST(QAssertTests,
     Q_ASSERT_ID(TEST_ID, true == false);
     mock().checkExpectations();
 }
+
+TEST(QAssertTests, QAssertMeta_find_returns_nothing_for_unknown_module)
+{
+    QAssertMetaDescription meta {};
+    CHECK_FALSE(cms::test::QAssertMetaFind("NotAQpModule", 1, &meta));
+    CHECK_FALSE(cms::test::QAssertMetaFind("NotAQpModule", 1, &meta));
+}
+
+TEST(QAssertTests, QAssertMeta_repeated_find_matches_qassert_meta_lookup)
+{
+    constexpr int MAX_ID = 1000;
+    for (int id = 0; id < MAX_ID; id += 10) {
+        QAssertMetaDescription expected {};
+        bool expectedFound = QAssertMetaGetDescription("qf_actq", id, &expected);
+
+        for (int repeat = 0; repeat < 2; ++repeat) {
+            QAssertMetaDescription meta {};
+            bool found = cms::test::QAssertMetaFind("qf_actq", id, &meta);
+            CHECK_EQUAL(expectedFound, found);
+            if (found) {
+                STRCMP_EQUAL(expected.brief, meta.brief);
+                STRCMP_EQUAL(expected.url, meta.url);
+            }
+        }
+    }
+}
+
+namespace {
+
+// The 'fromLast'th (from 0) described (module, id) of a few QP modules
+// which the rest of the suite does not look up, so that it is new to
+// the index. \return false if there is no such key.
+bool FindUnusedDescribedKey(std::size_t fromLast, const char** module,
+                            int* id)
+{
+    static const char* const MODULES[] = {"qep_hsm", "qep_msm", "qf_mem",
+                                          "qf_qeq", "qf_time", "qv"};
+    std::size_t remaining = fromLast;
+    for (std::size_t m = sizeof(MODULES) / sizeof(MODULES[0]); m > 0U; --m) {
+        for (int candidate = 999; candidate >= 0; --candidate) {
+            QAssertMetaDescription meta {};
+            if (QAssertMetaGetDescription(MODULES[m - 1U], candidate, &meta)) {
+                if (remaining == 0U) {
+                    *module = MODULES[m - 1U];
+                    *id     = candidate;
+                    return true;
+                }
+                --remaining;
+            }
+        }
+    }
+    return false;
+}
+
+// the index slot of (module, id): FNV-1a, as the index hashes its keys
+std::size_t MetaIndexSlot(const char* module, int id)
+{
+    std::uint32_t hash = 2166136261U;
+    for (const char* c = module; *c != '\0'; ++c) {
+        hash ^= static_cast<std::uint8_t>(*c);
+        hash *= 16777619U;
+    }
+    hash ^= static_cast<std::uint32_t>(id);
+    hash *= 16777619U;
+    return static_cast<std::size_t>(hash) & 255U;
+}
+
+}   // namespace
+
+TEST(QAssertTests, QAssertMeta_find_does_not_keep_the_callers_module_string)
+{
+    const char* module = nullptr;
+    int id             = 0;
+    if (!FindUnusedDescribedKey(0U, &module, &id)) {
+        return;   // nothing described to look up
+    }
+
+    // a name without a description, whose probe sequence passes through
+    // the slot of (module, id)
+    char other[16];
+    for (int n = 0; n < 100000; ++n) {
+        std::snprintf(other, sizeof(other), "zz%d", n);
+        if (MetaIndexSlot(other, id) == MetaIndexSlot(module, id)) {
+            break;
+        }
+    }
+
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%s", module);
+    CHECK_TRUE(cms::test::QAssertMetaFind(buffer, id, nullptr));
+
+    // an index keeping 'buffer' would now take its entry for 'other'
+    std::snprintf(buffer, sizeof(buffer), "%s", other);
+    CHECK_FALSE(cms::test::QAssertMetaFind(other, id, nullptr));
+    CHECK_TRUE(cms::test::QAssertMetaFind(module, id, nullptr));
+}
+
+TEST(QAssertTests, QAssertMeta_print_describes_each_key_once)
+{
+    const char* module = nullptr;
+    int id             = 0;
+    if (!FindUnusedDescribedKey(1U, &module, &id)) {
+        return;   // nothing described to print
+    }
+
+    std::FILE* out = std::tmpfile();
+    CHECK_TRUE(out != nullptr);
+    cms::test::QAssertMetaPrint(out, module, id);
+    cms::test::QAssertMetaPrint(out, module, id);
+    std::rewind(out);
+
+    int details      = 0;
+    int printedAbove = 0;
+    char line[512];
+    while (std::fgets(line, sizeof(line), out) != nullptr) {
+        details += (std::strstr(line, "Tips/More:") != nullptr) ? 1 : 0;
+        printedAbove +=
+          (std::strstr(line, "printed above.") != nullptr) ? 1 : 0;
+    }
+    std::fclose(out);
+
+    CHECK_EQUAL(1, details);
+    CHECK_EQUAL(1, printedAbove);
+}
+
+#ifdef CMS_QASSERT_DEATH_TEST_SUPPORTED
+
+static constexpr int NOEXCEPT_TEST_ID = 4321;
+
+static void AssertFromNoexceptFunction() noexcept
+{
+    Q_ASSERT_ID(NOEXCEPT_TEST_ID, true == false);
+}
+
+TEST(QAssertTests, death_test_reports_assert_raised_inside_noexcept_function)
+{
+    CMS_EXPECT_QASSERT_DEATH(Q_this_module_, NOEXCEPT_TEST_ID,
+                             AssertFromNoexceptFunction());
+}
+
+TEST(QAssertTests, death_test_reports_no_assert_when_body_returns_normally)
+{
+    int touched = 0;
+    auto result = cms::test::RunForQAssertDeath([&touched]() { touched = 1; });
+    CHECK_FALSE(result.asserted);
+
+    // the body ran in the child, leaving this process untouched.
+    LONGS_EQUAL(0, touched);
+}
+
+TEST(QAssertTests, death_test_reports_a_body_which_throws)
+{
+    auto result = cms::test::RunForQAssertDeath([]() { throw 1; });
+    CHECK_TRUE(result.threw);
+    CHECK_FALSE(result.asserted);
+}
+
+TEST(QAssertTests, death_test_reports_assert_from_within_qf)
+{
+    static const QP::QEvt outOfRange(QP::Q_USER_SIG + 10);
+    cms::test::qf_ctrl::Setup(QP::Q_USER_SIG + 1, 10);
+
+    auto result = cms::test::RunForQAssertDeath(
+      []() { QP::QF::PUBLISH(&outOfRange, nullptr); });
+    CHECK_TRUE(result.asserted);
+    STRCMP_EQUAL("qf_ps", result.module);
+
+    cms::test::qf_ctrl::Teardown();
+}
+
+#endif   // CMS_QASSERT_DEATH_TEST_SUPPORTED
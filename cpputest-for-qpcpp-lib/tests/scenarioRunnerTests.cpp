@@ -0,0 +1,237 @@
+/// @brief Tests for the qf_ctrl based scenario runner.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_scenario.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <cstdio>
+#include <cstring>
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+
+namespace {
+
+enum TestSigs : enum_t {
+    LIGHT_ON_PUB_SIG = QP::Q_USER_SIG,
+    LIGHT_OFF_PUB_SIG,
+    TEST_MAX_PUB_SIG,
+    BUTTON_SIG,
+    LIGHT_TIMEOUT_SIG
+};
+
+constexpr uint32_t TICKS_PER_SECOND = 100;
+constexpr const char* SCENARIO_FILE_NAME = "cms_qf_scenario_test.txt";
+
+/// Publishes LIGHT_ON when its button is pressed, then LIGHT_OFF a
+/// second later.
+class LightActiveObject : public QP::QActive {
+public:
+    LightActiveObject() :
+        QP::QActive(Q_STATE_CAST(initial)), m_queueStorage(),
+        m_timeout(this, LIGHT_TIMEOUT_SIG)
+    {
+        m_queueStorage.fill(nullptr);
+        start(qf_ctrl::UNIT_UNDER_TEST_PRIORITY, m_queueStorage.data(),
+              m_queueStorage.size(), nullptr, 0);
+    }
+
+private:
+    static QP::QState initial(LightActiveObject* const me,
+                              QP::QEvt const* const)
+    {
+        return me->tran(Q_STATE_CAST(&off));
+    }
+
+    static QP::QState off(LightActiveObject* const me, QP::QEvt const* const e)
+    {
+        QP::QState rtn;
+        switch (e->sig) {
+            case BUTTON_SIG:
+                me->PUBLISH(Q_NEW(QP::QEvt, LIGHT_ON_PUB_SIG), me);
+                me->m_timeout.armX(TICKS_PER_SECOND, 0);
+                rtn = me->tran(Q_STATE_CAST(&on));
+                break;
+            default:
+                rtn = me->super(&top);
+                break;
+        }
+        return rtn;
+    }
+
+    static QP::QState on(LightActiveObject* const me, QP::QEvt const* const e)
+    {
+        QP::QState rtn;
+        switch (e->sig) {
+            case LIGHT_TIMEOUT_SIG:
+                me->PUBLISH(Q_NEW(QP::QEvt, LIGHT_OFF_PUB_SIG), me);
+                rtn = me->tran(Q_STATE_CAST(&off));
+                break;
+            default:
+                rtn = me->super(&top);
+                break;
+        }
+        return rtn;
+    }
+
+    std::array<QP::QEvt const*, 10> m_queueStorage;
+    QP::QTimeEvt m_timeout;
+};
+
+QP::QActive* CreateLight()
+{
+    return new LightActiveObject();
+}
+
+void DestroyLight(QP::QActive* ao)
+{
+    delete static_cast<LightActiveObject*>(ao);
+}
+
+scenario::RunSummary Run(const char* text, FILE* log = nullptr)
+{
+    return scenario::RunText(text, std::strlen(text), "test", log);
+}
+
+}   // namespace
+
+TEST_GROUP(scenarioRunnerTests)
+{
+    void setup() final
+    {
+        scenario::Configure(TEST_MAX_PUB_SIG, TICKS_PER_SECOND);
+        CHECK_TRUE(scenario::RegisterActiveObject("Light", &CreateLight,
+                                                  &DestroyLight));
+        CHECK_TRUE(scenario::RegisterSignal("BUTTON_SIG", BUTTON_SIG));
+        CHECK_TRUE(scenario::RegisterSignal("LIGHT_ON", LIGHT_ON_PUB_SIG));
+        CHECK_TRUE(scenario::RegisterSignal("LIGHT_OFF", LIGHT_OFF_PUB_SIG));
+    }
+
+    void teardown() final
+    {
+        scenario::ClearRegistry();
+        std::remove(SCENARIO_FILE_NAME);
+    }
+};
+
+TEST(scenarioRunnerTests, registry_rejects_duplicate_names)
+{
+    CHECK_FALSE(scenario::RegisterActiveObject("Light", &CreateLight,
+                                               &DestroyLight));
+    CHECK_FALSE(scenario::RegisterSignal("BUTTON_SIG", BUTTON_SIG));
+}
+
+TEST(scenarioRunnerTests, passing_scenarios_are_counted)
+{
+    auto summary = Run("# the light turns off after a second\n"
+                       "scenario light times out\n"
+                       "  start Light\n"
+                       "  post Light BUTTON_SIG\n"
+                       "  expect LIGHT_ON\n"
+                       "  advance 999ms\n"
+                       "  expect-none\n"
+                       "  advance 1\n"
+                       "  expect LIGHT_OFF\n"
+                       "end\n"
+                       "\n"
+                       "scenario light stays off without a press\r\n"
+                       "  start Light\r\n"
+                       "  advance 5s\r\n"
+                       "  expect-none\r\n"
+                       "end");
+    CHECK_EQUAL(2U, summary.scenarios);
+    CHECK_EQUAL(2U, summary.passed);
+    CHECK_EQUAL(0U, summary.failed);
+    CHECK_EQUAL(10U, summary.steps);
+}
+
+TEST(scenarioRunnerTests, a_failing_step_fails_only_its_scenario)
+{
+    auto summary = Run("scenario wrong order\n"
+                       "  start Light\n"
+                       "  post Light BUTTON_SIG\n"
+                       "  expect LIGHT_OFF\n"
+                       "  expect LIGHT_ON\n"
+                       "end\n"
+                       "scenario passes\n"
+                       "  start Light\n"
+                       "end\n");
+    CHECK_EQUAL(2U, summary.scenarios);
+    CHECK_EQUAL(1U, summary.passed);
+    CHECK_EQUAL(1U, summary.failed);
+    CHECK_EQUAL(4U, summary.steps);
+}
+
+TEST(scenarioRunnerTests, failures_are_logged_with_line_and_reason)
+{
+    const char* logName = "cms_qf_scenario_test.log";
+    FILE* log           = std::fopen(logName, "w+");
+    CHECK_TRUE(log != nullptr);
+
+    auto summary = Run("scenario unknown names\n"
+                       "  start Light\n"
+                       "  publish NO_SUCH_SIG\n"
+                       "end\n",
+                       log);
+    CHECK_EQUAL(1U, summary.failed);
+
+    std::array<char, 160> line {};
+    std::rewind(log);
+    CHECK_TRUE(std::fgets(line.data(), line.size(), log) != nullptr);
+    std::fclose(log);
+    std::remove(logName);
+    STRCMP_EQUAL("test:3: unknown names: unknown signal 'NO_SUCH_SIG'\n",
+                 line.data());
+}
+
+TEST(scenarioRunnerTests, unterminated_scenario_fails)
+{
+    auto summary = Run("scenario no end\n"
+                       "  start Light\n");
+    CHECK_EQUAL(1U, summary.scenarios);
+    CHECK_EQUAL(1U, summary.failed);
+}
+
+TEST(scenarioRunnerTests, runs_scenarios_from_a_file)
+{
+    FILE* file = std::fopen(SCENARIO_FILE_NAME, "w");
+    CHECK_TRUE(file != nullptr);
+    std::fputs("scenario from a file\n"
+               "  start Light\n"
+               "  publish LIGHT_OFF\n"
+               "  expect-none\n"
+               "end\n",
+               file);
+    std::fclose(file);
+
+    auto summary = scenario::RunFile(SCENARIO_FILE_NAME, nullptr);
+    CHECK_EQUAL(1U, summary.passed);
+    CHECK_EQUAL(0U, summary.unreadableFiles);
+
+    summary = scenario::RunFile("no_such_scenario_file.txt", nullptr);
+    CHECK_EQUAL(1U, summary.unreadableFiles);
+    CHECK_EQUAL(0U, summary.scenarios);
+}
@@ -0,0 +1,175 @@
+/// @brief Tests for the port's QV and QK scheduling policies.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <string>
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+
+namespace {
+
+constexpr enum_t WORK_SIG = QP::Q_USER_SIG;
+
+/// Logs "<name>+" and "<name>-" around each WORK_SIG it handles, posting
+/// WORK_SIG to its target (if any) in between.
+class WorkerActiveObject : public QP::QActive {
+public:
+    WorkerActiveObject(char name, QP::QPrioSpec prioSpec, std::string* log,
+                       QP::QActive* target) :
+        QP::QActive(Q_STATE_CAST(initial)), m_name(name), m_log(log),
+        m_target(target), m_queueStorage()
+    {
+        m_queueStorage.fill(nullptr);
+        start(prioSpec, m_queueStorage.data(), m_queueStorage.size(),
+              nullptr, 0);
+    }
+
+private:
+    static QP::QState initial(WorkerActiveObject* const me,
+                              QP::QEvt const* const)
+    {
+        return me->tran(Q_STATE_CAST(&working));
+    }
+
+    static QP::QState working(WorkerActiveObject* const me,
+                              QP::QEvt const* const e)
+    {
+        static const QP::QEvt work(WORK_SIG);
+
+        QP::QState rtn;
+        switch (e->sig) {
+            case WORK_SIG:
+                me->m_log->push_back(me->m_name);
+                me->m_log->push_back('+');
+                if (me->m_target != nullptr) {
+                    me->m_target->POST(&work, me);
+                }
+                me->m_log->push_back(me->m_name);
+                me->m_log->push_back('-');
+                rtn = Q_HANDLED();
+                break;
+            default:
+                rtn = me->super(&top);
+                break;
+        }
+        return rtn;
+    }
+
+    char m_name;
+    std::string* m_log;
+    QP::QActive* m_target;
+    std::array<QP::QEvt const*, 10> m_queueStorage;
+};
+
+}   // namespace
+
+TEST_GROUP(schedulingPolicyTests)
+{
+    std::string mLog;
+    WorkerActiveObject* mHigh = nullptr;
+    WorkerActiveObject* mLow  = nullptr;
+
+    void setup() final
+    {
+        qf_ctrl::Setup(QP::Q_USER_SIG, 100);
+    }
+
+    void teardown() final
+    {
+        qf_ctrl::Teardown();
+        delete mLow;
+        delete mHigh;
+        mLog.clear();
+        mLog.shrink_to_fit();
+    }
+
+    void StartWorkers(QP::QPrioSpec lowPreemptionThreshold = 0U)
+    {
+        mHigh = new WorkerActiveObject('B', qf_ctrl::DUMMY_AO_B_PRIORITY,
+                                       &mLog, nullptr);
+        const auto lowPrioSpec = static_cast<QP::QPrioSpec>(
+          qf_ctrl::DUMMY_AO_A_PRIORITY | (lowPreemptionThreshold << 8U));
+        mLow = new WorkerActiveObject('A', lowPrioSpec, &mLog, mHigh);
+    }
+
+    // two events for the low priority worker, which posts to the high
+    void Run()
+    {
+        static const QP::QEvt work(WORK_SIG);
+        mLow->POST(&work, nullptr);
+        mLow->POST(&work, nullptr);
+        qf_ctrl::ProcessEvents();
+    }
+};
+
+TEST(schedulingPolicyTests, setup_selects_drain_queue)
+{
+    CHECK_TRUE(QP::GetSchedulingPolicy() == QP::SchedulingPolicy::DRAIN_QUEUE);
+}
+
+TEST(schedulingPolicyTests, drain_queue_empties_a_queue_before_choosing_again)
+{
+    StartWorkers();
+    Run();
+    STRCMP_EQUAL("A+A-A+A-B+B-B+B-", mLog.c_str());
+}
+
+TEST(schedulingPolicyTests, qv_chooses_again_after_each_event)
+{
+    QP::SetSchedulingPolicy(QP::SchedulingPolicy::QV);
+    StartWorkers();
+    Run();
+    STRCMP_EQUAL("A+A-B+B-A+A-B+B-", mLog.c_str());
+}
+
+TEST(schedulingPolicyTests, qk_preempts_at_the_post)
+{
+    QP::SetSchedulingPolicy(QP::SchedulingPolicy::QK);
+    StartWorkers();
+    Run();
+    STRCMP_EQUAL("A+B+B-A-A+B+B-A-", mLog.c_str());
+}
+
+TEST(schedulingPolicyTests, qk_honors_the_preemption_threshold)
+{
+    QP::SetSchedulingPolicy(QP::SchedulingPolicy::QK);
+    StartWorkers(qf_ctrl::DUMMY_AO_B_PRIORITY);
+    Run();
+    STRCMP_EQUAL("A+A-B+B-A+A-B+B-", mLog.c_str());
+}
+
+TEST(schedulingPolicyTests, qk_test_posts_wait_for_processing)
+{
+    static const QP::QEvt work(WORK_SIG);
+    QP::SetSchedulingPolicy(QP::SchedulingPolicy::QK);
+    StartWorkers();
+    mLow->POST(&work, nullptr);
+    CHECK_TRUE(mLog.empty());
+    qf_ctrl::ProcessEvents();
+    STRCMP_EQUAL("A+B+B-A-", mLog.c_str());
+}
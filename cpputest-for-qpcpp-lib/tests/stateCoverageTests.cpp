@@ -0,0 +1,169 @@
+/// @brief Tests for the state machine dispatch coverage map.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cms_cpputest_state_coverage.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <cstdio>
+#include "cmsTestReportText.hpp"
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+
+namespace {
+
+enum TestSigs : enum_t {
+    GO_SIG = QP::Q_USER_SIG,
+    STOP_SIG,
+    MAX_TEST_SIG
+};
+
+class TwoStateActiveObject : public QP::QActive {
+public:
+    TwoStateActiveObject() : QP::QActive(Q_STATE_CAST(initial)), m_queue()
+    {
+        m_queue.fill(nullptr);
+        start(qf_ctrl::UNIT_UNDER_TEST_PRIORITY, m_queue.data(),
+              m_queue.size(), nullptr, 0);
+    }
+
+    static QP::QState initial(TwoStateActiveObject* const me,
+                              QP::QEvt const* const)
+    {
+        return me->tran(Q_STATE_CAST(&idle));
+    }
+
+    static QP::QState idle(TwoStateActiveObject* const me,
+                           QP::QEvt const* const e)
+    {
+        return (e->sig == GO_SIG) ? me->tran(Q_STATE_CAST(&busy))
+                                  : me->super(&top);
+    }
+
+    static QP::QState busy(TwoStateActiveObject* const me,
+                           QP::QEvt const* const e)
+    {
+        return (e->sig == STOP_SIG) ? me->tran(Q_STATE_CAST(&idle))
+                                    : me->super(&top);
+    }
+
+private:
+    std::array<QP::QEvt const*, 5> m_queue;
+};
+
+QP::QStateHandler IdleState()
+{
+    return Q_STATE_CAST(&TwoStateActiveObject::idle);
+}
+
+QP::QStateHandler BusyState()
+{
+    return Q_STATE_CAST(&TwoStateActiveObject::busy);
+}
+
+}   // namespace
+
+TEST_GROUP(StateCoverageTests)
+{
+    void setup() final
+    {
+        coverage::Reset();
+    }
+
+    void teardown() final
+    {
+        coverage::Reset();
+    }
+};
+
+TEST(StateCoverageTests, recorded_pairs_are_covered)
+{
+    coverage::Record(nullptr, IdleState(), GO_SIG);
+
+    CHECK_TRUE(coverage::IsCovered(IdleState(), GO_SIG));
+    CHECK_FALSE(coverage::IsCovered(IdleState(), STOP_SIG));
+    CHECK_FALSE(coverage::IsCovered(BusyState(), GO_SIG));
+    CHECK_EQUAL(1U, coverage::CoveredPairs());
+}
+
+TEST(StateCoverageTests, reset_clears_counters)
+{
+    coverage::Record(nullptr, BusyState(), STOP_SIG);
+    coverage::Reset();
+    CHECK_FALSE(coverage::IsCovered(BusyState(), STOP_SIG));
+    CHECK_EQUAL(0U, coverage::CoveredPairs());
+}
+
+TEST(StateCoverageTests, signals_beyond_the_map_are_dropped)
+{
+    coverage::Record(nullptr, IdleState(),
+                     static_cast<QP::QSignal>(CMS_STATE_COVERAGE_MAX_SIGNALS));
+    CHECK_EQUAL(1U, coverage::Dropped());
+    CHECK_EQUAL(0U, coverage::CoveredPairs());
+}
+
+TEST(StateCoverageTests, counters_saturate_and_are_exposed_for_fuzzing)
+{
+    for (int i = 0; i < 300; ++i) {
+        coverage::Record(nullptr, IdleState(), GO_SIG);
+    }
+
+    const uint8_t* counters = coverage::Counters();
+    size_t nonZero          = 0;
+    for (size_t i = 0; i < coverage::CountersSize(); ++i) {
+        if (counters[i] != 0U) {
+            CHECK_EQUAL(UINT8_MAX, counters[i]);
+            ++nonZero;
+        }
+    }
+    CHECK_EQUAL(1U, nonZero);
+}
+
+TEST(StateCoverageTests, report_lists_named_states_and_their_signals)
+{
+    coverage::NameState(IdleState(), "TwoState::idle");
+    coverage::Record(nullptr, IdleState(), GO_SIG);
+    // the report includes states seen by any earlier test
+    CHECK_TRUE(ReportContains(&coverage::Report, "TwoState::idle: 4(x1)"));
+}
+
+#ifdef CMS_ENABLE_STATE_COVERAGE
+
+TEST(StateCoverageTests, active_object_dispatches_are_recorded)
+{
+    qf_ctrl::Setup(MAX_TEST_SIG, 100);
+    auto underTest = new TwoStateActiveObject();
+
+    qf_ctrl::PostAndProcess<GO_SIG>(underTest);
+    qf_ctrl::PostAndProcess<STOP_SIG>(underTest);
+
+    CHECK_TRUE(coverage::IsCovered(IdleState(), GO_SIG));
+    CHECK_TRUE(coverage::IsCovered(BusyState(), STOP_SIG));
+    CHECK_FALSE(coverage::IsCovered(BusyState(), GO_SIG));
+
+    qf_ctrl::Teardown();
+    delete underTest;
+}
+
+#endif   // CMS_ENABLE_STATE_COVERAGE
@@ -0,0 +1,227 @@
+/// @brief Tests for the StaticOrthogonalComponent (CRTP) class.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cmsStaticOrthogonalComponent.hpp"
+#include "cmsOrthogonalComponent.hpp"
+#include "cmsOrthogonalContainer.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include <array>
+#include <memory>
+#include "CppUTest/TestHarness.h"
+#include "CppUTestExt/MockSupport.h"
+
+using namespace cms;
+using namespace cms::test;
+
+enum InternalTestSigs {
+    STATIC_PUBLISH_SIG = QP::Q_USER_SIG + 1,
+    STATIC_POST_SIG,
+    VIRTUAL_POST_SIG,
+    UNDESIRED_SIG,
+    TEST_MAX_SIG
+};
+
+namespace {
+
+constexpr const char* STATIC_MOCK_NAME  = "StaticComponent";
+constexpr const char* VIRTUAL_MOCK_NAME = "VirtualComponent";
+
+class StaticTestComponent
+    : public StaticOrthogonalComponent<StaticTestComponent, STATIC_PUBLISH_SIG,
+                                       STATIC_POST_SIG> {
+    friend StaticOrthogonalComponent;
+
+public:
+    explicit StaticTestComponent(QP::QActive* container) :
+        StaticOrthogonalComponent(container, Q_STATE_CAST(initial))
+    {
+    }
+
+protected:
+    void subscribe()
+    {
+        m_container->subscribe(STATIC_PUBLISH_SIG);
+        mock(STATIC_MOCK_NAME).actualCall("subscribe");
+    }
+
+    static QP::QState initial(StaticTestComponent* const me,
+                              QP::QEvt const* const)
+    {
+        return me->tran(Q_STATE_CAST(&running));
+    }
+
+    static QP::QState running(StaticTestComponent* const me,
+                              QP::QEvt const* const e)
+    {
+        QP::QState rtn;
+        switch (e->sig) {
+            case Q_ENTRY_SIG:
+                mock(STATIC_MOCK_NAME).actualCall("running-entry");
+                rtn = Q_HANDLED();
+                break;
+            case STATIC_PUBLISH_SIG:
+                mock(STATIC_MOCK_NAME).actualCall("running-STATIC_PUBLISH_SIG");
+                rtn = Q_HANDLED();
+                break;
+            case STATIC_POST_SIG:
+                mock(STATIC_MOCK_NAME).actualCall("running-STATIC_POST_SIG");
+                rtn = Q_HANDLED();
+                break;
+            default:
+                rtn = me->super(&top);
+                break;
+        }
+        return rtn;
+    }
+};
+
+// the classic, virtual, component to confirm both kinds coexist
+class VirtualTestComponent : public OrthogonalComponent {
+public:
+    explicit VirtualTestComponent(QP::QActive* container) :
+        OrthogonalComponent(container, Q_STATE_CAST(initial))
+    {
+    }
+
+protected:
+    void subscribe() override
+    {
+        mock(VIRTUAL_MOCK_NAME).actualCall("subscribe");
+    }
+
+    bool isSignalDesired(enum_t sig) const override
+    {
+        return sig == VIRTUAL_POST_SIG;
+    }
+
+    static QP::QState initial(VirtualTestComponent* const me,
+                              QP::QEvt const* const)
+    {
+        return me->tran(Q_STATE_CAST(&running));
+    }
+
+    static QP::QState running(VirtualTestComponent* const me,
+                              QP::QEvt const* const e)
+    {
+        QP::QState rtn;
+        switch (e->sig) {
+            case Q_ENTRY_SIG:
+                mock(VIRTUAL_MOCK_NAME).actualCall("running-entry");
+                rtn = Q_HANDLED();
+                break;
+            case VIRTUAL_POST_SIG:
+                mock(VIRTUAL_MOCK_NAME).actualCall("running-VIRTUAL_POST_SIG");
+                rtn = Q_HANDLED();
+                break;
+            default:
+                rtn = me->super(&top);
+                break;
+        }
+        return rtn;
+    }
+};
+
+}   // namespace
+
+static_assert(StaticTestComponent::isSignalDesired(STATIC_PUBLISH_SIG),
+              "desired signal list must be usable at compile time");
+static_assert(!StaticTestComponent::isSignalDesired(UNDESIRED_SIG),
+              "undesired signal must not be reported as desired");
+
+TEST_GROUP(StaticOrthogonalComponentTests)
+{
+    std::array<const QP::QEvt*, 20> eventStorage {};
+
+    void setup() final
+    {
+        eventStorage.fill(nullptr);
+        qf_ctrl::Setup(TEST_MAX_SIG, 100);
+    }
+
+    void teardown() final
+    {
+        mock().clear();
+        cms::test::qf_ctrl::Teardown();
+    }
+
+    std::unique_ptr<QP::QActive> CreateAndStartMixedContainer()
+    {
+        mock().strictOrder();
+        mock(STATIC_MOCK_NAME).expectOneCall("subscribe");
+        mock(STATIC_MOCK_NAME).expectOneCall("running-entry");
+        mock(VIRTUAL_MOCK_NAME).expectOneCall("subscribe");
+        mock(VIRTUAL_MOCK_NAME).expectOneCall("running-entry");
+        auto underTest = std::unique_ptr<QP::QActive>(
+          new OrthogonalContainer<StaticTestComponent,
+                                  VirtualTestComponent>());
+        underTest->start(1, eventStorage.data(), eventStorage.size(), nullptr,
+                         0);
+        mock().checkExpectations();
+        return underTest;
+    }
+};
+
+TEST(StaticOrthogonalComponentTests,
+     static_component_dispatches_only_listed_signals)
+{
+    static const QP::QEvt postEvent      = QP::QEvt(STATIC_POST_SIG);
+    static const QP::QEvt undesiredEvent = QP::QEvt(UNDESIRED_SIG);
+
+    auto container = CreateAndStartMixedContainer();
+    StaticTestComponent underTest(container.get());
+
+    mock(STATIC_MOCK_NAME).expectOneCall("subscribe");
+    mock(STATIC_MOCK_NAME).expectOneCall("running-entry");
+    underTest.start();
+    mock().checkExpectations();
+
+    mock(STATIC_MOCK_NAME).expectOneCall("running-STATIC_POST_SIG");
+    CHECK_TRUE(underTest.componentDispatch(&postEvent));
+    CHECK_FALSE(underTest.componentDispatch(&undesiredEvent));
+    mock().checkExpectations();
+}
+
+TEST(StaticOrthogonalComponentTests,
+     container_routes_to_static_and_virtual_components)
+{
+    static const QP::QEvt staticEvent  = QP::QEvt(STATIC_POST_SIG);
+    static const QP::QEvt virtualEvent = QP::QEvt(VIRTUAL_POST_SIG);
+
+    auto underTest = CreateAndStartMixedContainer();
+
+    mock(STATIC_MOCK_NAME).expectOneCall("running-STATIC_POST_SIG");
+    mock(VIRTUAL_MOCK_NAME).expectOneCall("running-VIRTUAL_POST_SIG");
+    qf_ctrl::PostAndProcess(&staticEvent, underTest.get());
+    qf_ctrl::PostAndProcess(&virtualEvent, underTest.get());
+    mock().checkExpectations();
+}
+
+TEST(StaticOrthogonalComponentTests,
+     container_routes_published_event_to_static_component)
+{
+    auto underTest = CreateAndStartMixedContainer();
+
+    mock(STATIC_MOCK_NAME).expectOneCall("running-STATIC_PUBLISH_SIG");
+    qf_ctrl::PublishAndProcess(STATIC_PUBLISH_SIG);
+    mock().checkExpectations();
+}
@@ -0,0 +1,224 @@
+/// @brief Tests for the port's TrafficTap.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cmsDummyActiveObject.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <array>
+#include <vector>
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+
+namespace {
+
+constexpr enum_t MAX_PUB_SIG = QP::Q_USER_SIG + 10;
+constexpr enum_t SIG_A       = QP::Q_USER_SIG + 1;
+constexpr enum_t SIG_B       = QP::Q_USER_SIG + 2;
+constexpr enum_t SIG_C       = QP::Q_USER_SIG + 3;
+
+enum class Traffic { PUBLISH, POST, DELIVERY, RECEIVE };
+
+struct TrafficRecord {
+    Traffic kind;
+    enum_t sig;
+    void const* who;   // sender, or receiver for Traffic::RECEIVE
+};
+
+using TrafficLog = std::vector<TrafficRecord>;
+
+void OnPublish(void* context, QP::QEvt const* e, void const* sender)
+{
+    static_cast<TrafficLog*>(context)->push_back(
+      {Traffic::PUBLISH, e->sig, sender});
+}
+
+void OnPost(void* context, QP::QEvt const* e, void const* sender,
+            bool delivery)
+{
+    static_cast<TrafficLog*>(context)->push_back(
+      {delivery ? Traffic::DELIVERY : Traffic::POST, e->sig, sender});
+}
+
+void OnReceive(void* context, QP::QActive const* receiver, QP::QEvt const* e)
+{
+    static_cast<TrafficLog*>(context)->push_back(
+      {Traffic::RECEIVE, e->sig, receiver});
+}
+
+}   // namespace
+
+TEST_GROUP(TrafficTapTests)
+{
+    DefaultDummyActiveObjectUniquePtr mDummyA;
+    DefaultDummyActiveObjectUniquePtr mDummyB;
+    TrafficLog mLog;
+    QP::TrafficTap mTap = {&OnPublish, &OnPost, &OnReceive, &mLog};
+    int mSender = 0;
+
+    void setup() final
+    {
+        qf_ctrl::Setup(MAX_PUB_SIG, 1000);
+        mDummyA = CreateAndStartDummyActiveObject(
+          DefaultDummyActiveObject::EventBehavior::CALLBACK,
+          qf_ctrl::DUMMY_AO_A_PRIORITY);
+        mDummyB = CreateAndStartDummyActiveObject(
+          DefaultDummyActiveObject::EventBehavior::CALLBACK,
+          qf_ctrl::DUMMY_AO_B_PRIORITY);
+        CHECK_TRUE(QP::AddTrafficTap(&mTap));
+    }
+
+    void teardown() final
+    {
+        QP::RemoveTrafficTap(&mTap);
+        qf_ctrl::Teardown();
+        mDummyA.reset();
+        mDummyB.reset();
+    }
+
+    void CheckRecord(std::size_t index, Traffic kind, enum_t sig,
+                     void const* who)
+    {
+        CHECK_TRUE(index < mLog.size());
+        CHECK_TRUE(mLog[index].kind == kind);
+        CHECK_EQUAL(sig, mLog[index].sig);
+        POINTERS_EQUAL(who, mLog[index].who);
+    }
+};
+
+TEST(TrafficTapTests, sees_a_publish_its_deliveries_and_their_receipt)
+{
+    mDummyA->subscribe(SIG_A);
+    mDummyB->subscribe(SIG_A);
+
+    QP::QActive::PUBLISH(Q_NEW(QP::QEvt, SIG_A), &mSender);
+    qf_ctrl::ProcessEvents();
+
+    CHECK_EQUAL(5U, mLog.size());
+    CheckRecord(0U, Traffic::PUBLISH, SIG_A, &mSender);
+    CheckRecord(1U, Traffic::DELIVERY, SIG_A, &mSender);
+    CheckRecord(2U, Traffic::DELIVERY, SIG_A, &mSender);
+    // the higher priority subscriber first
+    CheckRecord(3U, Traffic::RECEIVE, SIG_A, mDummyB.get());
+    CheckRecord(4U, Traffic::RECEIVE, SIG_A, mDummyA.get());
+}
+
+TEST(TrafficTapTests, a_post_by_a_subscriber_preempting_the_publish_is_not_a_delivery)
+{
+    static const QP::QEvt eventB(SIG_B);
+    static const QP::QEvt eventC(SIG_C);
+    QP::SetSchedulingPolicy(QP::SchedulingPolicy::QK);
+    mDummyB->subscribe(SIG_A);
+    mDummyA->SetPostedEventHandler([this](QP::QEvt const* e) {
+        if (e->sig == SIG_C) {
+            QP::QActive::PUBLISH(Q_NEW(QP::QEvt, SIG_A), mDummyA.get());
+        }
+    });
+    mDummyB->SetPostedEventHandler([this](QP::QEvt const*) {
+        mDummyA->POST(&eventB, mDummyB.get());
+    });
+
+    mDummyA->POST(&eventC, &mSender);
+    qf_ctrl::ProcessEvents();
+
+    // B runs as QF's publish ends, before the publish returns to A
+    CHECK_EQUAL(7U, mLog.size());
+    CheckRecord(0U, Traffic::POST, SIG_C, &mSender);
+    CheckRecord(1U, Traffic::RECEIVE, SIG_C, mDummyA.get());
+    CheckRecord(2U, Traffic::PUBLISH, SIG_A, mDummyA.get());
+    CheckRecord(3U, Traffic::DELIVERY, SIG_A, mDummyA.get());
+    CheckRecord(4U, Traffic::RECEIVE, SIG_A, mDummyB.get());
+    CheckRecord(5U, Traffic::POST, SIG_B, mDummyB.get());
+    CheckRecord(6U, Traffic::RECEIVE, SIG_B, mDummyA.get());
+}
+
+TEST(TrafficTapTests, sees_a_publish_without_any_subscriber)
+{
+    QP::QActive::PUBLISH(Q_NEW(QP::QEvt, SIG_B), &mSender);
+    qf_ctrl::ProcessEvents();
+
+    CHECK_EQUAL(1U, mLog.size());
+    CheckRecord(0U, Traffic::PUBLISH, SIG_B, &mSender);
+}
+
+TEST(TrafficTapTests, sees_a_direct_post_and_its_receipt)
+{
+    static const QP::QEvt event(SIG_B);
+    mDummyB->POST(&event, &mSender);
+    qf_ctrl::ProcessEvents();
+
+    CHECK_EQUAL(2U, mLog.size());
+    CheckRecord(0U, Traffic::POST, SIG_B, &mSender);
+    CheckRecord(1U, Traffic::RECEIVE, SIG_B, mDummyB.get());
+}
+
+TEST(TrafficTapTests, observing_does_not_change_pool_usage)
+{
+    mDummyA->subscribe(SIG_A);
+    qf_ctrl::PublishEvent(SIG_A);
+    CHECK_EQUAL(1U, qf_ctrl::PoolEventsInUse());
+
+    qf_ctrl::ProcessEvents();
+    CHECK_EQUAL(0U, qf_ctrl::PoolEventsInUse());
+}
+
+TEST(TrafficTapTests, a_removed_tap_sees_nothing)
+{
+    QP::RemoveTrafficTap(&mTap);
+    qf_ctrl::PublishEvent(SIG_A);
+    qf_ctrl::ProcessEvents();
+
+    CHECK_TRUE(mLog.empty());
+}
+
+TEST(TrafficTapTests, a_tap_may_leave_callbacks_null)
+{
+    QP::RemoveTrafficTap(&mTap);
+    QP::TrafficTap publishOnly = {&OnPublish, nullptr, nullptr, &mLog};
+    CHECK_TRUE(QP::AddTrafficTap(&publishOnly));
+
+    mDummyA->subscribe(SIG_A);
+    qf_ctrl::PublishAndProcess(SIG_A);
+    QP::RemoveTrafficTap(&publishOnly);
+
+    CHECK_EQUAL(1U, mLog.size());
+    CheckRecord(0U, Traffic::PUBLISH, SIG_A, nullptr);
+}
+
+TEST(TrafficTapTests, add_fails_once_the_taps_are_exhausted)
+{
+    std::array<QP::TrafficTap, 8> taps{};
+    std::size_t added = 1U;   // mTap
+    while ((added < taps.size()) && QP::AddTrafficTap(&taps[added])) {
+        ++added;
+    }
+
+    CHECK_TRUE(added < taps.size());
+    CHECK_FALSE(QP::AddTrafficTap(&taps[0]));
+
+    for (std::size_t i = 1U; i < added; ++i) {
+        QP::RemoveTrafficTap(&taps[i]);
+    }
+}
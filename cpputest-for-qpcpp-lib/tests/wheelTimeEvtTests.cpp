@@ -0,0 +1,190 @@
+/// @brief Tests for the timing wheel backed cms::WheelTimeEvt.
+/// @ingroup
+/// @cond
+///***************************************************************************
+///
+/// Copyright (C) 2022 Matthew Eshleman. All rights reserved.
+///
+/// This program is open source software: you can redistribute it and/or
+/// modify it under the terms of the GNU General Public License as published
+/// by the Free Software Foundation, either version 3 of the License, or
+/// (at your option) any later version.
+///
+/// Alternatively, upon written permission from Matthew Eshleman, this program
+/// may be distributed and modified under the terms of a Commercial
+/// License. For further details, see the Contact Information below.
+///
+/// Contact Information:
+///   Matthew Eshleman
+///   https://covemountainsoftware.com
+///   info@covemountainsoftware.com
+///***************************************************************************
+/// @endcond
+
+#include "cmsWheelTimeEvt.hpp"
+#include "cmsDummyActiveObject.hpp"
+#include "cms_cpputest_qf_ctrl.hpp"
+#include "qpcpp.hpp"
+#include <chrono>
+#include <memory>
+#include <vector>
+
+//cpputest header include must always be last
+#include "CppUTest/TestHarness.h"
+
+using namespace cms::test;
+using std::chrono::milliseconds;
+
+namespace {
+
+constexpr enum_t TIMEOUT_SIG        = QP::Q_USER_SIG;
+constexpr uint32_t TICKS_PER_SECOND = 1000;   // one tick per millisecond
+
+/// records the tick it was posted at, and how often
+struct TestTimeEvt : cms::WheelTimeEvt {
+    explicit TestTimeEvt(QP::QActive* act) :
+        cms::WheelTimeEvt(act, TIMEOUT_SIG), expectedTick(0), postedTick(0),
+        postCount(0)
+    {
+    }
+
+    uint64_t expectedTick;
+    uint64_t postedTick;
+    uint32_t postCount;
+};
+
+}   // namespace
+
+TEST_GROUP(wheelTimeEvtTests)
+{
+    cms::test::DefaultDummyActiveObject* mDummy = nullptr;
+    std::vector<std::unique_ptr<TestTimeEvt>> mTimeEvts;
+    size_t mPosted = 0;
+
+    void setup() final
+    {
+        qf_ctrl::Setup(QP::Q_USER_SIG, TICKS_PER_SECOND);
+        mDummy = new cms::test::DefaultDummyActiveObject();
+        mDummy->dummyStart();
+        mDummy->SetPostedEventHandler([this](QP::QEvt const* e) {
+            // the posted event is the (non-const) time event itself
+            auto te = const_cast<TestTimeEvt*>(
+              static_cast<TestTimeEvt const*>(e));
+            te->postedTick = qf_ctrl::TicksSinceSetup();
+            ++te->postCount;
+            ++mPosted;
+        });
+    }
+
+    void teardown() final
+    {
+        mTimeEvts.clear();
+        mTimeEvts.shrink_to_fit();
+        qf_ctrl::Teardown();
+        delete mDummy;
+    }
+
+    TestTimeEvt& AddTimeEvt()
+    {
+        mTimeEvts.push_back(std::unique_ptr<TestTimeEvt>(new TestTimeEvt(mDummy)));
+        return *mTimeEvts.back();
+    }
+};
+
+TEST(wheelTimeEvtTests, one_shot_is_posted_once_after_its_ticks)
+{
+    auto& te = AddTimeEvt();
+    te.armX(5);
+    CHECK_TRUE(te.isArmed());
+    CHECK_EQUAL(5U, te.getCtr());
+
+    qf_ctrl::MoveTimeForward(milliseconds(4));
+    CHECK_EQUAL(0U, te.postCount);
+    CHECK_EQUAL(1U, te.getCtr());
+
+    qf_ctrl::MoveTimeForward(milliseconds(100));
+    CHECK_EQUAL(1U, te.postCount);
+    CHECK_EQUAL(5U, te.postedTick);
+    CHECK_FALSE(te.isArmed());
+    CHECK_EQUAL(0U, te.getCtr());
+}
+
+TEST(wheelTimeEvtTests, periodic_is_posted_every_interval)
+{
+    auto& te = AddTimeEvt();
+    te.armX(3, 2);
+
+    qf_ctrl::MoveTimeForward(milliseconds(10));
+    CHECK_EQUAL(4U, te.postCount);   // ticks 3, 5, 7 and 9
+    CHECK_EQUAL(9U, te.postedTick);
+    CHECK_TRUE(te.isArmed());
+}
+
+TEST(wheelTimeEvtTests, disarm_and_rearm_report_if_the_time_event_was_armed)
+{
+    auto& te = AddTimeEvt();
+    CHECK_FALSE(te.disarm());
+
+    te.armX(10);
+    CHECK_TRUE(te.disarm());
+    CHECK_FALSE(te.disarm());
+    qf_ctrl::MoveTimeForward(milliseconds(20));
+    CHECK_EQUAL(0U, te.postCount);
+
+    CHECK_FALSE(te.rearm(5));
+    CHECK_TRUE(te.rearm(10));
+    qf_ctrl::MoveTimeForward(milliseconds(9));
+    CHECK_EQUAL(0U, te.postCount);
+    qf_ctrl::MoveTimeForward(milliseconds(1));
+    CHECK_EQUAL(1U, te.postCount);
+    CHECK_EQUAL(30U, te.postedTick);
+}
+
+TEST(wheelTimeEvtTests, delays_cascading_through_the_levels_post_on_time)
+{
+    for (uint32_t delay : {1U, 63U, 64U, 65U, 4095U, 4096U, 4097U, 262143U,
+                           262144U, 300001U}) {
+        auto& te        = AddTimeEvt();
+        te.expectedTick = delay;
+        te.armX(delay);
+    }
+
+    qf_ctrl::MoveTimeForward(std::chrono::seconds(301));
+    for (const auto& te : mTimeEvts) {
+        CHECK_EQUAL(1U, te->postCount);
+        CHECK_EQUAL(te->expectedTick, te->postedTick);
+    }
+}
+
+TEST(wheelTimeEvtTests, thousands_of_armed_time_events_post_on_time)
+{
+    constexpr uint32_t TIME_EVT_COUNT = 5000;
+    mTimeEvts.reserve(TIME_EVT_COUNT);
+
+    // armed part way through the wheel, in an order unrelated to expiry
+    qf_ctrl::MoveTimeForward(milliseconds(37));
+    for (uint32_t i = 0; i < TIME_EVT_COUNT; ++i) {
+        auto& te             = AddTimeEvt();
+        const uint32_t delay = 1U + (i * 7919U) % TIME_EVT_COUNT;
+        te.expectedTick      = 37U + delay;
+        te.armX(delay);
+    }
+
+    // disarm every tenth, as a connection closing before its timeout
+    for (uint32_t i = 0; i < TIME_EVT_COUNT; i += 10U) {
+        CHECK_TRUE(mTimeEvts[i]->disarm());
+    }
+
+    qf_ctrl::MoveTimeForward(milliseconds(TIME_EVT_COUNT + 1));
+    CHECK_EQUAL(TIME_EVT_COUNT - TIME_EVT_COUNT / 10U, mPosted);
+    for (uint32_t i = 0; i < TIME_EVT_COUNT; ++i) {
+        const auto& te = *mTimeEvts[i];
+        if ((i % 10U) == 0U) {
+            CHECK_EQUAL(0U, te.postCount);
+        }
+        else {
+            CHECK_EQUAL(1U, te.postCount);
+            CHECK_EQUAL(te.expectedTick, te.postedTick);
+        }
+    }
+}